@@ -0,0 +1,276 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include "LSTypeBits.hpp"
+#include "SuffixArrayInducedSortingInPlace.hpp"
+
+///bit 7 of the header-byte marks a stored Burrows-Wheeler-transform instead of a suffix-array
+const unsigned char BWTHeaderBit = 1 << 7;
+
+///Template-Function-Object for creating the Burrows-Wheeler-transform without the suffix-array of the input
+template<typename alph=char, typename idxT=size_t>
+class BWTInducedSorting{
+   ///This is the induced sorting of SA-IS, where the suffixes of one bucket are not stored in the suffix-array,
+   ///but only wait in a FIFO-queue of their bucket until the scan reaches it, as described by D. Okanohara and K. Sadakane
+   ///in "A Linear-Time Burrows-Wheeler Transform Using Induced Sorting".
+   ///
+   ///Every suffix, that is induced, is popped once when the scan passes its bucket, then the char in front of it is written at
+   ///its rank and the suffix in front of it is pushed, so a queue only holds the suffixes between the scan and their
+   ///inducing suffix. Besides the input and the transform the build takes:
+   ///- the bit-packed L/S-Types (2 bits per char)
+   ///- the sorted LMS-suffixes and the summary of the LMS-substrings (at most n/2 indices each)
+   ///- the suffix-array of the summary, which is built by *SuffixArrayInducedSortingInPlace* and becomes the sorted LMS-suffixes
+   ///- the queues (at most n/2 indices, far less on most inputs)
+   ///
+   ///The L-suffixes, whose suffix in front is S-Type, induce the S-Types and are kept for the second scan.
+   ///Every one of them ends a run of S-Types, that starts with a LMS-suffix (or index 0) of a smaller bucket,
+   ///so they are stored in the front of the LMS-suffixes, that the first scan already passed.
+   ///
+   ///The transform has n+1 entries like the suffix-array, entry i is the char in front of the suffix of rank i,
+   ///the entry of suffix 0 (*primary*) has no char in front of it and is set to 0.
+public:
+   ///*min* is the smallest char of the input
+   explicit BWTInducedSorting(const idxT& min=0)
+   : subtract(min)
+   {}
+
+   ///returns the transform of *alph_cont*, *max* is the biggest char of *alph_cont*,
+   ///the chars of the transform are taken from *chars* at the same indices, if it is given (e.g. the symbols of ranks)
+   std::vector<alph> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max,
+                                idxT& primary,
+                                const std::vector<alph>* chars=nullptr) const {
+      const idxT n = alph_cont.size();
+      primary = 0;
+      if(!n)
+         return std::vector<alph>(1);
+      const size_t sigma = size_t(idxT(max) - subtract) + 1;
+      LSTypeBits<idxT> STypes(alph_cont);
+
+      ///1. the first rank of every bucket, rank 0 is the empty suffix
+      std::vector<idxT> bounds(sigma + 1, 0);
+      for(idxT i = 0 ; i < n ; ++i)
+         ++bounds[bucket(alph_cont[i]) + 1];
+      bounds[0] = 1;
+      for(size_t c = 1 ; c <= sigma ; ++c)
+         bounds[c] += bounds[c-1];
+
+      ///2. the LMS-suffixes ordered by their first chars, they are stored from index 1 on (see *induce*)
+      std::vector<idxT> lms;
+      {
+         std::vector<idxT> fill(sigma + 1, 0);
+         STypes.forEachLMS([&](const idxT& i){ ++fill[bucket(alph_cont[i]) + 1]; });
+         for(size_t c = 1 ; c <= sigma ; ++c)
+            fill[c] += fill[c-1];
+         lms.resize(fill[sigma] + 1);
+         STypes.forEachLMS([&](const idxT& i){ lms[++fill[bucket(alph_cont[i])]] = i; });
+      }
+      const idxT m = lms.size() - 1;
+
+      ///3. sorting the LMS-substrings, if their names are not unique, the order of the LMS-suffixes is the suffix-array of the summary
+      if(m){
+         induce(alph_cont, STypes, bounds, lms, nullptr, nullptr, primary);
+         std::vector<idxT> summary(m);
+         const idxT names = name(alph_cont, STypes, lms, summary);
+         if(names < m){
+            std::vector<idxT>().swap(lms);
+            std::vector<idxT> summarySA = SuffixArrayInducedSortingInPlace<idxT,idxT>(1)(summary, names);
+            idxT k = 0;
+            STypes.forEachLMS([&](const idxT& i){ summary[k++] = i; });
+            ///the suffix-array of the summary is overwritten with the LMS-suffixes, entry 0 stays unused
+            for(k = 1 ; k <= m ; ++k)
+               summarySA[k] = summary[summarySA[k]];
+            lms.swap(summarySA);
+         }
+         std::vector<idxT>().swap(summary);
+      }
+
+      ///4. inducing the transform from the sorted LMS-suffixes, it is allocated behind the recursion
+      std::vector<alph> bwt(uint64_t(n) + 1);
+      induce(alph_cont, STypes, bounds, lms, chars ? chars : &alph_cont, &bwt, primary);
+      return bwt;
+   }
+
+private:
+   idxT bucket(const alph& c) const {
+      return idxT(c) - subtract;
+   }
+
+   ///FIFO-queues of indices, one per bucket, the entries are stored in blocks of *Block* indices from one pool,
+   ///that only grows to the count of blocks in use at the same time. The pool is allocated in slabs of *SlabBlocks* blocks,
+   ///so it grows without copying and without the spare capacity of a growing vector
+   class BucketQueues{
+   public:
+      explicit BucketQueues(const size_t& buckets)
+      : queues(buckets)
+      {}
+
+      bool empty(const size_t& b) const {
+         return queues[b].first == None;
+      }
+
+      void push(const size_t& b, const idxT& i){
+         Queue& q = queues[b];
+         if(q.first == None){
+            q.first = q.last = allocate();
+            q.head = q.tail = 0;
+         }
+         else if(q.tail == Block){
+            const size_t blk = allocate();
+            next[q.last] = blk;
+            q.last = blk;
+            q.tail = 0;
+         }
+         entry(q.last, q.tail++) = i;
+      }
+
+      idxT pop(const size_t& b){
+         Queue& q = queues[b];
+         const idxT i = entry(q.first, q.head++);
+         if(q.first == q.last && q.head == q.tail){
+            free_blocks.push_back(q.first);
+            q.first = None;
+         }
+         else if(q.head == Block){
+            free_blocks.push_back(q.first);
+            q.first = next[q.first];
+            q.head = 0;
+         }
+         return i;
+      }
+
+   private:
+      static const size_t Block = 64;
+      static const size_t SlabBlocks = 1 << 10;
+      static const size_t None = size_t(-1);
+
+      struct Queue{
+         size_t first = None;
+         size_t last = None;
+         unsigned head = 0;
+         unsigned tail = 0;
+      };
+
+      size_t allocate(){
+         if(free_blocks.size()){
+            const size_t blk = free_blocks.back();
+            free_blocks.pop_back();
+            return blk;
+         }
+         if(next.size() % SlabBlocks == 0)
+            slabs.emplace_back(new idxT[SlabBlocks * Block]);
+         next.push_back(size_t(None));
+         return next.size() - 1;
+      }
+
+      idxT& entry(const size_t& blk, const unsigned& i){
+         return slabs[blk / SlabBlocks][(blk % SlabBlocks) * Block + i];
+      }
+
+      std::vector<Queue> queues;
+      std::vector<std::unique_ptr<idxT[]>> slabs;
+      std::vector<size_t> next;
+      std::vector<size_t> free_blocks;
+   };
+
+   ///induces the L-Types from the LMS-suffixes lms[1, m] and the S-Types from the L-Types
+   ///- without *bwt* *lms* is ordered by the first chars and becomes ordered by the LMS-substrings
+   ///- with *bwt* *lms* is sorted, the char of *chars* in front of every suffix is written at its rank
+   ///
+   ///The L-suffixes of the buckets up to c, whose suffix in front is S-Type, are at most as many as the LMS-suffixes
+   ///in front of bucket c plus index 0, so they are written to lms[0, ...) behind the first scan and read in front of the
+   ///LMS-suffixes, that the second scan writes to the back of *lms*.
+   void induce(const std::vector<alph>& alph_cont,
+               const LSTypeBits<idxT>& STypes,
+               const std::vector<idxT>& bounds,
+               std::vector<idxT>& lms,
+               const std::vector<alph>* chars,
+               std::vector<alph>* bwt,
+               idxT& primary) const {
+      const idxT n = alph_cont.size();
+      const size_t sigma = bounds.size() - 1;
+      BucketQueues queues(sigma);
+      auto emit = [&](const idxT& r, const idxT& j){
+         if(!bwt)
+            return;
+         if(j)
+            (*bwt)[r] = (*chars)[j-1];
+         else{
+            (*bwt)[r] = 0;
+            primary = r;
+         }
+      };
+      ///count of the L-suffixes, whose suffix in front is S-Type, and the end of the ones of every bucket
+      idxT turns = 0;
+      std::vector<idxT> turns_end(sigma);
+
+      ///1. L-Types from the smallest bucket to the biggest, the empty suffix comes first
+      emit(0, n);
+      queues.push(bucket(alph_cont[n-1]), n-1);
+      idxT next_lms = 1;
+      for(size_t c = 0 ; c < sigma ; ++c){
+         idxT r = bounds[c];
+         while(!queues.empty(c)){
+            const idxT j = queues.pop(c);
+            emit(r++, j);
+            if(j){
+               if(!STypes.isS(j-1))
+                  queues.push(bucket(alph_cont[j-1]), j-1);
+               else
+                  lms[turns++] = j;
+            }
+         }
+         turns_end[c] = turns;
+         for( ; next_lms < lms.size() && bucket(alph_cont[lms[next_lms]]) == c ; ++next_lms)
+            queues.push(bucket(alph_cont[lms[next_lms]-1]), lms[next_lms]-1);
+      }
+
+      ///2. S-Types from the biggest bucket to the smallest, the S-Types of a bucket are in front of its L-Types
+      idxT k = lms.size();
+      for(size_t c = sigma ; c-- > 0 ; ){
+         idxT r = bounds[c+1];
+         while(!queues.empty(c)){
+            const idxT j = queues.pop(c);
+            emit(--r, j);
+            if(j){
+               if(STypes.isS(j-1))
+                  queues.push(bucket(alph_cont[j-1]), j-1);
+               else if(!bwt)
+                  lms[--k] = j;
+            }
+         }
+         for(idxT t = turns_end[c] ; t > (c ? turns_end[c-1] : idxT(0)) ; --t)
+            queues.push(bucket(alph_cont[lms[t-1]-1]), lms[t-1]-1);
+      }
+   }
+
+   ///names the LMS-substrings in the order of lms[1, m], the names are stored in the order of the text in *summary*,
+   ///returns the count of names
+   idxT name(const std::vector<alph>& alph_cont,
+             const LSTypeBits<idxT>& STypes,
+             const std::vector<idxT>& lms,
+             std::vector<idxT>& summary) const {
+      const idxT n = alph_cont.size();
+      const std::vector<idxT> directory = STypes.lmsDirectory();
+      idxT names = 0;
+      idxT prev = 0;
+      idxT prev_end = n;
+      for(idxT k = 1 ; k < lms.size() ; ++k){
+         const idxT p = lms[k];
+         const idxT end = STypes.nextLMS(p);
+         ///a LMS-substring, that ends with the empty suffix, is unique
+         if(end == n || prev_end == n || end - p != prev_end - prev
+            || !std::equal(alph_cont.begin() + p, alph_cont.begin() + end + 1, alph_cont.begin() + prev))
+            ++names;
+         summary[STypes.lmsRank(p, directory)] = names;
+         prev = p;
+         prev_end = end;
+      }
+      return names;
+   }
+
+   const idxT subtract;
+};
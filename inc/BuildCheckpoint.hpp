@@ -0,0 +1,141 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+///Files of the recursion-levels of a SA-IS-build, from which a stopped build continues
+class BuildCheckpoint{
+   ///Two kinds of files are stored under *dir*/SA_cp_*tag*_*kind*_*level*.tmp:
+   ///- "level": the pointer-vector and the summary of a recursion-level and the alphabet-size of the summary,
+   ///written after the level is sorted on the way down (the types and counts are built again from the input of the level)
+   ///- "sorted": the suffix-array of the input of a level, written on the way up
+   ///
+   ///A file is renamed to its final name, when it is complete, so a stopped build leaves no partial files.
+   ///The *tag* identifies the input and the options of the build, every level is sorted deterministically,
+   ///so the files of one build can be mixed with the files of another build with the same tag.
+public:
+   ///constructor sets the directory of the files, the tag of the build and if the stored levels are restored
+   BuildCheckpoint(const std::string& directory,
+                   const std::string& build_tag,
+                   const bool& resume)
+   : dir(directory), tag(build_tag), resuming(resume), restored_files(0)
+   {}
+
+   ///checks if the stored levels are restored instead of sorted again
+   bool resumes() const {
+      return resuming;
+   }
+
+   ///count of files, that were restored
+   unsigned restored() const {
+      return restored_files;
+   }
+
+   template<typename idxT>
+   void saveLevel(const unsigned& level,
+                  const idxT& summ_alph_s,
+                  const std::vector<idxT>& idc,
+                  const std::vector<idxT>& summary) const {
+      const std::string f_name = name("level", level);
+      std::ofstream out(f_name + ".part", std::ios::binary);
+      out.write((const char*)&summ_alph_s, sizeof(idxT));
+      writeVector(out, idc);
+      writeVector(out, summary);
+      finish(out, f_name);
+   }
+
+   ///reads the pointer-vector, the summary and the alphabet-size of the summary of *level*, false if they are not stored
+   template<typename idxT>
+   bool loadLevel(const unsigned& level,
+                  idxT& summ_alph_s,
+                  std::vector<idxT>& idc,
+                  std::vector<idxT>& summary) const {
+      std::ifstream in(name("level", level), std::ios::binary);
+      if(!in.is_open())
+         return false;
+      in.read((char*)&summ_alph_s, sizeof(idxT));
+      if(!readVector(in, idc) || !readVector(in, summary) || in.peek() != EOF){
+         idc.clear();
+         summary.clear();
+         return false;
+      }
+      ++restored_files;
+      return true;
+   }
+
+   template<typename idxT>
+   void saveSorted(const unsigned& level, const std::vector<idxT>& SA) const {
+      const std::string f_name = name("sorted", level);
+      std::ofstream out(f_name + ".part", std::ios::binary);
+      writeVector(out, SA);
+      finish(out, f_name);
+   }
+
+   ///reads the suffix-array of the input of *level*, false if it is not stored
+   template<typename idxT>
+   bool loadSorted(const unsigned& level, std::vector<idxT>& SA) const {
+      std::ifstream in(name("sorted", level), std::ios::binary);
+      if(!in.is_open())
+         return false;
+      if(!readVector(in, SA) || in.peek() != EOF){
+         SA.clear();
+         return false;
+      }
+      ++restored_files;
+      return true;
+   }
+
+   ///removes the files of the build
+   void clear() const {
+      for(unsigned level = 0 ; ; ++level){
+         const bool l = !std::remove(name("level", level).c_str());
+         const bool s = !std::remove(name("sorted", level).c_str());
+         ///the level-files are consecutive from level 0, the sorted-files start at level 1
+         if(!l && !s && level)
+            break;
+      }
+   }
+
+private:
+   std::string name(const std::string& kind, const unsigned& level) const {
+      std::stringstream buf;
+      buf << dir << "/SA_cp_" << tag << '_' << kind << '_' << level << ".tmp";
+      return buf.str();
+   }
+
+   template<typename idxT>
+   static void writeVector(std::ostream& out, const std::vector<idxT>& v){
+      const idxT s = v.size();
+      out.write((const char*)&s, sizeof(idxT));
+      if(v.size())
+         out.write((const char*)&v[0], sizeof(idxT) * v.size());
+   }
+
+   template<typename idxT>
+   static bool readVector(std::istream& in, std::vector<idxT>& v){
+      idxT s = 0;
+      if(!in.read((char*)&s, sizeof(idxT)))
+         return false;
+      v.resize(s);
+      if(s)
+         in.read((char*)&v[0], sizeof(idxT) * v.size());
+      return bool(in);
+   }
+
+   ///closes the file and renames it to its final name
+   static void finish(std::ofstream& out, const std::string& f_name){
+      out.close();
+      if(!out || std::rename((f_name + ".part").c_str(), f_name.c_str())){
+         std::cerr << "ERROR : Failed to write checkpoint ''" << f_name << "''\n";
+         exit(1);
+      }
+   }
+
+   const std::string dir;
+   const std::string tag;
+   const bool resuming;
+   mutable unsigned restored_files;
+};
@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <algorithm>
+#include <cstddef>
+
+///Pool of buffers of type *T*, that keeps the capacity of returned buffers for the next builds
+template<typename T>
+class BufferPool{
+   ///A buffer is taken with *take* and handed back with *give*.
+   ///*take* reuses the smallest free buffer, that can hold the requested size,
+   ///if none is big enough, a new buffer is allocated and the free buffers keep their capacity for the following requests,
+   ///so a repeated sequence of requests stops allocating after its first run.
+public:
+   ///returns a buffer of *size* elements, that are set to *value*
+   std::vector<T> take(const size_t& size, const T& value=T()){
+      std::vector<T> buf;
+      size_t best = free.size();
+      for(size_t i = 0 ; i < free.size() ; ++i){
+         if(free[i].capacity() >= size && (best == free.size() || free[i].capacity() < free[best].capacity()))
+            best = i;
+      }
+      if(best < free.size()){
+         buf.swap(free[best]);
+         free[best].swap(free.back());
+         free.pop_back();
+      }
+      else if(size){
+         ++grown;
+      }
+      buf.assign(size, value);
+      return buf;
+   }
+
+   ///hands the buffer *buf* back to the pool, *buf* is empty afterwards
+   void give(std::vector<T>& buf){
+      if(!buf.capacity())
+         return;
+      buf.clear();
+      free.push_back(std::vector<T>());
+      free.back().swap(buf);
+   }
+
+   ///count of taken buffers, that had to allocate
+   size_t allocations() const {
+      return grown;
+   }
+
+private:
+   std::vector<std::vector<T>> free;
+   size_t grown = 0;
+};
+
+///Buffers of repeated builds, that can be passed to the suffix-array-engines
+class BuildContext{
+   ///An engine constructed with a *BuildContext* takes its working buffers and the returned suffix-array from the pools of the context
+   ///and hands the working buffers back at the end of the build.
+   ///The returned suffix-array is handed back by the caller (*pool<idxT>().give(SA)*), when it is not used anymore,
+   ///then the following builds of inputs up to the same size do not allocate the buffers again.
+   ///
+   ///A context is not thread-safe, every thread, that builds, needs its own.
+public:
+   ///returns the pool of buffers of type *T*
+   template<typename T>
+   BufferPool<T>& pool(){
+      std::unique_ptr<PoolHolder>& holder = pools[std::type_index(typeid(T))];
+      if(!holder)
+         holder.reset(new TypedPoolHolder<T>());
+      return static_cast<TypedPoolHolder<T>*>(holder.get())->pool;
+   }
+
+   ///count of taken buffers of all pools, that had to allocate
+   size_t allocations() const {
+      size_t a = 0;
+      for(const auto& p : pools){
+         a += p.second->allocations();
+      }
+      return a;
+   }
+
+private:
+   struct PoolHolder{
+      virtual ~PoolHolder(){}
+      virtual size_t allocations() const = 0;
+   };
+
+   template<typename T>
+   struct TypedPoolHolder : public PoolHolder{
+      size_t allocations() const {
+         return pool.allocations();
+      }
+      BufferPool<T> pool;
+   };
+
+   std::map<std::type_index, std::unique_ptr<PoolHolder>> pools;
+};
+
+///buffer of *size* elements set to *value*, from the pool of *ctx* or newly allocated, if there is no context
+template<typename T>
+std::vector<T> takeBuffer(BuildContext* ctx, const size_t& size, const T& value=T()){
+   return ctx ? ctx->pool<T>().take(size, value) : std::vector<T>(size, value);
+}
+
+///hands *buf* back to the pool of *ctx*, without a context *buf* is freed
+template<typename T>
+void giveBuffer(BuildContext* ctx, std::vector<T>& buf){
+   if(ctx)
+      ctx->pool<T>().give(buf);
+   else
+      std::vector<T>().swap(buf);
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+///phases of a construction, that are recorded by *BuildStats*
+enum class BuildPhase{
+   ///L-S-Types and counts of a recursion-step
+   Types,
+   ///placement of the LMS-chars at the ends of their buckets
+   GuessSort,
+   ///induce-sort-step of the L-Types
+   LInduce,
+   ///induce-sort-step of the S-Types
+   SInduce,
+   ///naming of the LMS-substrings (summary)
+   Naming,
+   ///placement of the sorted LMS-suffixes at the ends of their buckets
+   LMSSort,
+   ///whole call of the suffix-array-engine
+   Build,
+   ///lcp-lr-arrays
+   LCP,
+   ///writing or searching the suffix-array
+   Output
+};
+
+///names of the phases in the report
+inline const char* phaseName(const BuildPhase& phase){
+   static const char* names[] = {"types", "guess-sort", "l-induce", "s-induce", "naming", "lms-sort", "build", "lcp", "output"};
+   return names[static_cast<unsigned>(phase)];
+}
+
+///Wall time, bytes and element-counts of the phases of a construction, per recursion-level
+class BuildStats{
+   ///The engines get a pointer to the statistics, a *nullptr* switches the recording off,
+   ///then every phase only checks the pointer (see *PhaseTimer*).
+   ///Repeated phases of the same level (e.g. both induce-steps of a level) are summed up.
+   ///
+   ///- *bytes* are the bytes of the buffers, that a phase takes (newly allocated or from a *BuildContext*)
+   ///- *elements* are the entries a phase processes: the length of the level's input for types, guess-sort and the induce-steps,
+   ///the LMS-substrings for the naming and the LMS-suffixes for the lms-sort
+public:
+   struct Record{
+      BuildPhase phase;
+      unsigned level;
+      uint64_t calls;
+      double seconds;
+      uint64_t bytes;
+      uint64_t elements;
+   };
+
+   void add(const BuildPhase& phase,
+            const unsigned& level,
+            const double& seconds,
+            const uint64_t& bytes,
+            const uint64_t& elements){
+      for(Record& r : records){
+         if(r.phase == phase && r.level == level){
+            ++r.calls;
+            r.seconds += seconds;
+            r.bytes += bytes;
+            r.elements += elements;
+            return;
+         }
+      }
+      records.push_back(Record{phase, level, 1, seconds, bytes, elements});
+   }
+
+   const std::vector<Record>& get() const {
+      return records;
+   }
+
+   ///writes one tab-separated line per phase and level in the order of their first call, after a header-line
+   void report(std::ostream& out) const {
+      out << "phase\tlevel\tcalls\tseconds\tbytes\telements\n";
+      for(const Record& r : records){
+         out << phaseName(r.phase) << '\t' << r.level << '\t' << r.calls << '\t'
+             << r.seconds << '\t' << r.bytes << '\t' << r.elements << '\n';
+      }
+   }
+
+private:
+   std::vector<Record> records;
+};
+
+///records the time from its construction to its destruction as one call of a phase, if *stats* is not *nullptr*
+class PhaseTimer{
+public:
+   PhaseTimer(BuildStats* s,
+              const BuildPhase& p,
+              const unsigned& l,
+              const uint64_t& e)
+   : stats(s), phase(p), level(l), elements(e), bytes(0)
+   {
+      if(stats)
+         start = std::chrono::steady_clock::now();
+   }
+
+   ~PhaseTimer(){
+      if(stats){
+         stats->add(phase, level,
+                    std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count(),
+                    bytes,
+                    elements);
+      }
+   }
+
+   ///adds the bytes of a buffer, that the phase takes
+   template<typename Buffer>
+   void takes(const Buffer& buf){
+      bytes += buf.size() * sizeof(buf[0]);
+   }
+
+   void takesBytes(const uint64_t& b){
+      bytes += b;
+   }
+
+   void setElements(const uint64_t& e){
+      elements = e;
+   }
+
+private:
+   BuildStats* const stats;
+   const BuildPhase phase;
+   const unsigned level;
+   uint64_t elements;
+   uint64_t bytes;
+   std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+///Synthetic input-corpora for measuring the suffix-array-engines, every corpus is reproducible from its kind, size and seed
+
+///kinds of corpora, that *makeCorpus* generates
+inline const std::vector<std::string>& corpusKinds(){
+   static const std::vector<std::string> kinds = {"random", "text", "dna", "repetitive", "fibonacci", "same"};
+   return kinds;
+}
+
+///uniformly random bytes, no structure to exploit
+inline void randomCorpus(std::vector<unsigned char>& T, std::mt19937_64& rnd){
+   for(unsigned char& c : T){
+      c = rnd();
+   }
+}
+
+///words of a Zipf-distributed vocabulary, separated by spaces, punctuation and newlines, like natural language
+inline void textCorpus(std::vector<unsigned char>& T, std::mt19937_64& rnd){
+   ///letters by their frequency in english text
+   static const std::string letters = "eeeeeeeeeeeeettttttttttaaaaaaaaooooooooiiiiiiinnnnnnnssssssrrrrrrhhhhhhllllddddcccuuummmwwffggyyppbbvkjxqz";
+   const size_t words = 20000;
+   std::vector<std::string> vocabulary(words);
+   std::geometric_distribution<unsigned> length(0.25);
+   for(std::string& w : vocabulary){
+      const unsigned l = 1 + std::min(length(rnd), 13u);
+      for(unsigned i = 0 ; i < l ; ++i){
+         w += letters[rnd() % letters.size()];
+      }
+   }
+   ///the r-th word is drawn with a probability proportional to 1/(r+1)
+   std::vector<double> cumulative(words);
+   double sum = 0;
+   for(size_t r = 0 ; r < words ; ++r){
+      sum += 1.0 / (r + 1);
+      cumulative[r] = sum;
+   }
+   std::uniform_real_distribution<double> draw(0, sum);
+   size_t i = 0, in_sentence = 0;
+   while(i < T.size()){
+      const size_t r = std::min<size_t>(words - 1, std::lower_bound(cumulative.begin(), cumulative.end(), draw(rnd)) - cumulative.begin());
+      for(size_t k = 0 ; k < vocabulary[r].size() && i < T.size() ; ++k){
+         T[i++] = in_sentence || k ? vocabulary[r][k] : vocabulary[r][k] - 'a' + 'A';
+      }
+      ++in_sentence;
+      const char sep = in_sentence > 8 && rnd() % 4 == 0 ? '.' : rnd() % 12 == 0 ? ',' : ' ';
+      if(sep != ' ' && i < T.size())
+         T[i++] = sep;
+      if(sep == '.'){
+         in_sentence = 0;
+      }
+      if(i < T.size())
+         T[i++] = sep == '.' && rnd() % 5 == 0 ? '\n' : ' ';
+   }
+}
+
+///uniformly random nucleotides
+inline void dnaCorpus(std::vector<unsigned char>& T, std::mt19937_64& rnd){
+   static const char bases[] = "ACGT";
+   for(unsigned char& c : T){
+      c = bases[rnd() & 3];
+   }
+}
+
+///copies of one text-block, every copy changes about one of 1000 characters, like the versions of a document
+inline void repetitiveCorpus(std::vector<unsigned char>& T, std::mt19937_64& rnd){
+   std::vector<unsigned char> block(std::min<size_t>(T.size(), 1 << 16));
+   textCorpus(block, rnd);
+   for(size_t i = 0 ; i < T.size() ; i += block.size()){
+      for(size_t k = 0 ; k < 1 + block.size() / 1000 ; ++k){
+         block[rnd() % block.size()] = 'a' + rnd() % 26;
+      }
+      std::copy(block.begin(), block.begin() + std::min(block.size(), T.size() - i), T.begin() + i);
+   }
+}
+
+///prefix of the infinite Fibonacci-word over {a, b}, which is highly repetitive without being periodic
+inline void fibonacciCorpus(std::vector<unsigned char>& T){
+   ///the Fibonacci-word is the fixed point of a -> ab, b -> a, so T[i] follows from the prefix, that is already written
+   if(T.empty())
+      return;
+   T[0] = 'a';
+   size_t read = 0, i = 0;
+   while(i < T.size()){
+      const bool a = T[read++] == 'a';
+      T[i++] = 'a';
+      if(a && i < T.size())
+         T[i++] = 'b';
+   }
+}
+
+///returns a corpus of *size* bytes of the kind *kind*, see *corpusKinds*
+inline std::vector<unsigned char> makeCorpus(const std::string& kind,
+                                             const size_t& size,
+                                             const uint64_t& seed=1){
+   std::vector<unsigned char> T(size);
+   std::mt19937_64 rnd(seed);
+   if(kind == "random")
+      randomCorpus(T, rnd);
+   else if(kind == "text")
+      textCorpus(T, rnd);
+   else if(kind == "dna")
+      dnaCorpus(T, rnd);
+   else if(kind == "repetitive")
+      repetitiveCorpus(T, rnd);
+   else if(kind == "fibonacci")
+      fibonacciCorpus(T);
+   else if(kind == "same")
+      std::fill(T.begin(), T.end(), 'a');
+   else{
+      std::cerr << "ERROR : corpus ''" << kind << "'' unknown\n";
+      exit(1);
+   }
+   return T;
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "SuffixArrayInducedSortingInPlace.hpp"
+
+///Ranks of a difference-cover sample of the suffixes of a text, that bound the comparison of any two suffixes
+template<typename alph, typename idxT>
+class DifferenceCoverSample{
+   ///The sample holds every suffix *i*, whose remainder i mod *Cover* is in the difference-cover *D*
+   ///(J. Kärkkäinen, P. Sanders and S. Burkhardt, "Linear work suffix array construction").
+   ///For all remainders a and b there is a l < *Cover*, so that a+l and b+l are in *D*,
+   ///so two suffixes are ordered by at most *Cover* characters and the ranks of the sampled suffixes behind them.
+   ///
+   ///*D* = {0, .., r} + {r*j} with r*r = *Cover*, so 31 of 256 suffixes are sampled. The substrings of *Cover* characters
+   ///of the sampled suffixes are named by a multikey-quicksort, the names of every remainder follow each other in the order
+   ///of the text, closed by an unique name. The suffix-array of the names (*SuffixArrayInducedSortingInPlace*) is the order
+   ///of the sampled suffixes. The ranks take 0.125n words, the build about 0.25n words beside the text.
+public:
+   explicit DifferenceCoverSample(const std::vector<alph>& alph_cont)
+   : T(alph_cont.data()), n(alph_cont.size()), slot(Cover, -1), delta(Cover * Cover, 0)
+   {
+      for(unsigned x = 0 ; x < Cover ; ++x){
+         if(x <= Root || x % Root == 0){
+            slot[x] = cover.size();
+            cover.push_back(x);
+         }
+      }
+      for(unsigned a = 0 ; a < Cover ; ++a){
+         for(unsigned b = 0 ; b < Cover ; ++b){
+            unsigned l = 0;
+            while(slot[(a + l) % Cover] < 0 || slot[(b + l) % Cover] < 0)
+               ++l;
+            delta[a * Cover + b] = l;
+         }
+      }
+      rankSample();
+   }
+
+   ///checks if the suffix *i* is smaller than the suffix *j*, both are smaller than n
+   bool less(const idxT& i, const idxT& j) const {
+      if(i == j)
+         return false;
+      const uint64_t a = i, b = j;
+      const unsigned l = delta[(a % Cover) * Cover + b % Cover];
+      for(unsigned t = 0 ; t < l ; ++t){
+         if(a + t == n)
+            return true;
+         if(b + t == n)
+            return false;
+         if(T[a + t] != T[b + t])
+            return T[a + t] < T[b + t];
+      }
+      if(a + l == n)
+         return true;
+      if(b + l == n)
+         return false;
+      return rankOf(a + l) < rankOf(b + l);
+   }
+
+private:
+   static const unsigned Cover = 256;
+   static const unsigned Root = 16;
+   ///ranges smaller than this are sorted by insertion-sort
+   static const size_t SmallRange = 16;
+
+   uint64_t rankOf(const uint64_t& i) const {
+      return ranks[(i / Cover) * cover.size() + slot[i % Cover]];
+   }
+
+   ///character *d* of the substring of the suffix *i*, 0 behind the end of the text or of the substring
+   uint64_t key(const uint64_t& i, const unsigned& d) const {
+      return d < Cover && i + d < n ? uint64_t(T[i + d]) + 1 : 0;
+   }
+
+   ///compares the substrings of *Cover* characters of the suffixes *i* and *j*, from character *d*
+   int compareSubstrings(const uint64_t& i, const uint64_t& j, unsigned d) const {
+      for( ; d < Cover ; ++d){
+         const uint64_t x = key(i, d), y = key(j, d);
+         if(x != y)
+            return x < y ? -1 : 1;
+         if(!x)
+            return 0;
+      }
+      return 0;
+   }
+
+   ///multikey-quicksort of the suffixes pos[b, e) by their substrings of *Cover* characters, that are equal up to *d*
+   void sortSubstrings(std::vector<idxT>& pos, size_t b, size_t e, unsigned d) const {
+      while(e - b >= SmallRange && d < Cover){
+         const uint64_t x = key(pos[b], d), y = key(pos[b + ((e - b) >> 1)], d), z = key(pos[e - 1], d);
+         const uint64_t v = x < y ? (y < z ? y : (x < z ? z : x))
+                                  : (y > z ? y : (x > z ? z : x));
+         ///pos[b, lt) < v, pos[lt, i) == v, pos[i, gt) unread, pos[gt, e) > v
+         size_t lt = b, i = b, gt = e;
+         while(i < gt){
+            const uint64_t c = key(pos[i], d);
+            if(c < v)
+               std::swap(pos[lt++], pos[i++]);
+            else if(c > v)
+               std::swap(pos[i], pos[--gt]);
+            else
+               ++i;
+         }
+         sortSubstrings(pos, b, lt, d);
+         sortSubstrings(pos, gt, e, d);
+         ///the substrings, that ended, are equal
+         if(!v)
+            return;
+         b = lt;
+         e = gt;
+         ++d;
+      }
+      for(size_t i = b + 1 ; i < e ; ++i){
+         for(size_t j = i ; j > b && compareSubstrings(pos[j - 1], pos[j], d) > 0 ; --j)
+            std::swap(pos[j - 1], pos[j]);
+      }
+   }
+
+   ///sorts the sampled suffixes and stores their ranks
+   void rankSample(){
+      const size_t k = cover.size();
+      ///1. the names of remainder c are names[start[c], start[c+1]-1), closed by the name c
+      std::vector<uint64_t> start(k + 1, 0);
+      for(size_t c = 0 ; c < k ; ++c)
+         start[c + 1] = start[c] + (n > cover[c] ? (n - cover[c] - 1) / Cover + 1 : 0) + 1;
+      std::vector<idxT> pos;
+      pos.reserve(start[k] - k);
+      for(size_t c = 0 ; c < k ; ++c){
+         for(uint64_t i = cover[c] ; i < n ; i += Cover)
+            pos.push_back(i);
+      }
+      sortSubstrings(pos, 0, pos.size(), 0);
+      std::vector<idxT> names(start[k]);
+      for(size_t c = 0 ; c < k ; ++c)
+         names[start[c + 1] - 1] = c;
+      uint64_t name = k - 1;
+      for(size_t x = 0 ; x < pos.size() ; ++x){
+         if(!x || compareSubstrings(pos[x - 1], pos[x], 0))
+            ++name;
+         const uint64_t i = pos[x];
+         names[start[slot[i % Cover]] + i / Cover] = name;
+      }
+      std::vector<idxT>().swap(pos);
+      ///2. the suffix-array of the names orders the sampled suffixes
+      std::vector<idxT> SA = SuffixArrayInducedSortingInPlace<idxT,idxT>(0)(names, name);
+      std::vector<idxT>().swap(names);
+      ranks.assign(((n + Cover - 1) / Cover) * k, 0);
+      for(uint64_t r = 1 ; r < SA.size() ; ++r){
+         const uint64_t p = SA[r];
+         const size_t c = std::upper_bound(start.begin(), start.end(), p) - start.begin() - 1;
+         if(p + 1 < start[c + 1])
+            ranks[(p - start[c]) * k + c] = r;
+      }
+   }
+
+   const alph* T;
+   const uint64_t n;
+   ///position of every remainder in *cover*, -1 if it is not sampled
+   std::vector<int> slot;
+   ///the remainders of the sampled suffixes
+   std::vector<unsigned> cover;
+   ///delta[a * Cover + b] is the smallest l, so that a+l and b+l are sampled
+   std::vector<unsigned char> delta;
+   ///ranks of the sampled suffixes, in the order of their positions
+   std::vector<idxT> ranks;
+};
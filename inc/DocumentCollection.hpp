@@ -0,0 +1,108 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sys/stat.h>
+
+///symbol behind every document of a collection (''-docs''), it is smaller than all symbols of the documents
+///and never part of a pattern, so a match never reaches into the next document
+const unsigned DocumentSeparator = 0;
+
+///paths of the documents of a collection, one per line of the file *list*, empty lines are skipped
+inline std::vector<std::string> documentPaths(const std::string& list){
+   std::ifstream in(list);
+   std::vector<std::string> paths;
+   for(std::string line ; std::getline(in, line) ; ){
+      if(line.size() && line.back() == '\r')
+         line.pop_back();
+      if(line.size())
+         paths.push_back(line);
+   }
+   return paths;
+}
+
+///bytes of all documents plus one separator per document,
+///an upper bound of the size of the input for choosing the index-width
+inline uint64_t documentsSize(const std::vector<std::string>& paths){
+   uint64_t size = 0;
+   for(const std::string& path : paths){
+      struct stat st;
+      size += (stat(path.c_str(), &st) ? 0 : st.st_size) + 1;
+   }
+   return size;
+}
+
+///Starts of the documents in the concatenated input, maps a position to its document and the offset inside of it
+template<typename idxT=size_t>
+class DocumentBoundaries{
+   ///- bit i of *bits* is set, if a document starts at position i
+   ///- *directory* holds the count of the set bits in front of every word, so the document of a position is found in constant time
+   ///- *starts* holds the first position of every document and the size of the input
+   ///
+   ///Only *starts* is stored, the bits are built again when it is read.
+public:
+   ///builds the bits of the documents starting at *doc_starts* (ascending, the first one is 0) in an input of *n* symbols
+   void build(const std::vector<idxT>& doc_starts, const idxT& n){
+      starts = doc_starts;
+      starts.push_back(n);
+      bits.assign((uint64_t(n) >> 6) + 1, 0);
+      for(idxT d = 0 ; d + 1 < starts.size() ; ++d)
+         bits[uint64_t(starts[d]) >> 6] |= uint64_t(1) << (uint64_t(starts[d]) & 63);
+      directory.resize(bits.size());
+      idxT count = 0;
+      for(size_t w = 0 ; w < bits.size() ; ++w){
+         directory[w] = count;
+         count += __builtin_popcountll(bits[w]);
+      }
+   }
+
+   ///count of documents, 0 if the input is no collection
+   idxT count() const {
+      return starts.size() ? starts.size() - 1 : 0;
+   }
+
+   ///document of position *pos* and the offset of *pos* inside of it
+   std::pair<idxT,idxT> locate(const idxT& pos) const {
+      const uint64_t w = uint64_t(pos) >> 6;
+      const uint64_t below = bits[w] & (~uint64_t(0) >> (63 - (uint64_t(pos) & 63)));
+      const idxT doc = directory[w] + __builtin_popcountll(below) - 1;
+      return std::pair<idxT,idxT>(doc, pos - starts[doc]);
+   }
+
+   ///binary write behind the suffix-array: a marker, the count of documents and their starts
+   void write(std::ostream& out) const {
+      out.write(Marker, sizeof(Marker));
+      const idxT d = count();
+      out.write((const char*)&d, sizeof(idxT));
+      out.write((const char*)starts.data(), sizeof(idxT) * starts.size());
+   }
+
+   ///reads what *write* stored, false if there are no documents behind the suffix-array
+   bool read(std::istream& in){
+      char marker[sizeof(Marker)];
+      idxT d;
+      if(!in.read(marker, sizeof(Marker)) || memcmp(marker, Marker, sizeof(Marker)) || !in.read((char*)&d, sizeof(idxT)))
+         return false;
+      std::vector<idxT> doc_starts(uint64_t(d) + 1);
+      if(!in.read((char*)doc_starts.data(), sizeof(idxT) * doc_starts.size()))
+         return false;
+      const idxT n = doc_starts.back();
+      doc_starts.pop_back();
+      build(doc_starts, n);
+      return true;
+   }
+
+private:
+   static constexpr char Marker[4] = {'D', 'O', 'C', 'S'};
+
+   std::vector<uint64_t> bits;
+   std::vector<idxT> directory;
+   std::vector<idxT> starts;
+};
+
+template<typename idxT>
+constexpr char DocumentBoundaries<idxT>::Marker[4];
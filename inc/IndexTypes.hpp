@@ -0,0 +1,99 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdint>
+
+///Unsigned 40-bit index, stored in 5 bytes
+class uint40{
+   ///- converts implicitly from and to *uint64_t*, so all arithmetic is done on 64 bits and truncated on assignment
+   ///- *std::vector<uint40>* takes 5 bytes per index instead of 8, enough for inputs up to 512 GiB
+public:
+   uint40() = default;
+
+   uint40(const uint64_t& v)
+   : lo(uint32_t(v)), hi(uint8_t(v >> 32))
+   {}
+
+   operator uint64_t() const {
+      return (uint64_t(hi) << 32) | lo;
+   }
+
+   uint40& operator+=(const uint64_t& v){ return *this = uint64_t(*this) + v; }
+   uint40& operator-=(const uint64_t& v){ return *this = uint64_t(*this) - v; }
+   uint40& operator|=(const uint64_t& v){ return *this = uint64_t(*this) | v; }
+   uint40& operator&=(const uint64_t& v){ return *this = uint64_t(*this) & v; }
+   uint40& operator<<=(const unsigned& s){ return *this = uint64_t(*this) << s; }
+   uint40& operator>>=(const unsigned& s){ return *this = uint64_t(*this) >> s; }
+   uint40& operator++(){ return *this += 1; }
+   uint40& operator--(){ return *this -= 1; }
+   uint40 operator++(int){ uint40 bef = *this; ++(*this); return bef; }
+   uint40 operator--(int){ uint40 bef = *this; --(*this); return bef; }
+
+private:
+   uint32_t lo;
+   uint8_t hi;
+} __attribute__((packed));
+
+inline std::istream& operator>>(std::istream& in, uint40& i){
+   uint64_t v;
+   in >> v;
+   i = v;
+   return in;
+}
+
+///code of the index-width, stored in bits 4-5 of the header-byte of a stored suffix-array
+///0: 4 bytes (files written before the code existed), 1: 5 bytes, 2: 8 bytes
+template<typename idxT>
+unsigned char indexWidthCode(){
+   return sizeof(idxT) == 4 ? 0 : (sizeof(idxT) == 5 ? 1 : 2);
+}
+
+inline unsigned indexWidthFromCode(const unsigned char& header){
+   const unsigned char code = (header >> 4) & 3;
+   return code == 0 ? 4 : (code == 1 ? 5 : 8);
+}
+
+///code of the symbol-width, stored in bits 1-2 of the header-byte of a stored suffix-array
+///0: 1 byte (files written before the code existed), 1: 2 bytes, 2: 4 bytes
+template<typename alph>
+unsigned char alphabetWidthCode(){
+   return sizeof(alph) == 1 ? 0 : (sizeof(alph) == 2 ? 1 : 2);
+}
+
+inline unsigned alphabetWidthFromCode(const unsigned char& header){
+   const unsigned char code = (header >> 1) & 3;
+   return code == 0 ? 1 : (code == 1 ? 2 : 4);
+}
+
+///smallest index-width in bytes, that can address *data_size* positions plus the empty suffix
+///and still leaves the highest bit free for the engines marking indices with it
+inline unsigned indexWidthForSize(const uint64_t& data_size){
+   if(data_size + 1 < (uint64_t(1) << 31))
+      return 4;
+   if(data_size + 1 < (uint64_t(1) << 39))
+      return 5;
+   return 8;
+}
+
+///index-width for building a suffix-array of the file *f_name*, the file size is an upper bound of the input-size
+inline unsigned indexWidthForFile(const std::string& f_name){
+   std::ifstream stream(f_name, std::ios::binary | std::ios::ate);
+   if(!stream.is_open()){
+      return 4;
+   }
+   return indexWidthForSize(uint64_t(stream.tellg()));
+}
+
+///header-byte of a previously stored suffix-array, 0 if it can not be read
+inline unsigned char headerOfStored(const std::string& f_name){
+   std::ifstream stream(f_name, std::ios::binary);
+   unsigned char header = 0;
+   stream.read(reinterpret_cast<char*>(&header), 1);
+   return header;
+}
+
+///index-width of a previously stored suffix-array
+inline unsigned indexWidthOfStored(const std::string& f_name){
+   return indexWidthFromCode(headerOfStored(f_name));
+}
@@ -24,10 +24,16 @@ private:
                         invSA = make_inverse(SA, data.size());
       ///iterates over indices of data
       ///compares two neighbouring indices of SA, getting the neighbour via the inverted suffix-array
+      ///the last suffix of SA has no neighbour, the comparison stops at the end of the shorter suffix
       for(idxT i = 0, h = 0 ; i < data.size() ; ++i){
+            if(invSA[i] + 1 == SA.size()){
+               h = 0;
+               continue;
+            }
+            const idxT j = SA[invSA[i]+1];
             std::equal(data.cbegin()+i+h, 
-                       data.cend(), 
-                       data.cbegin()+SA[invSA[i]+1]+h, 
+                       data.cbegin()+i+std::min(data.size()-i, data.size()-j), 
+                       data.cbegin()+j+h, 
                        Compare(&h));
             lcp[invSA[i]] = h;
             if(h) --h;
@@ -215,8 +221,11 @@ std::pair<idxT,idxT> lower_bound(const std::vector<alph>& data,
       i += step;
       
       idxT depth = 0;
+      ///a suffix, that ends before the pattern, is smaller
+      smaller = true;
+      const idxT len = std::min<idxT>(data.size() - SA[i], val.size()) - depth_bef;
       std::equal(data.cbegin() + SA[i] + depth_bef, 
-                 data.cend(), 
+                 data.cbegin() + SA[i] + depth_bef + len, 
                  val.cbegin() + depth_bef,
                  Find_if_unequal<alph, idxT>(&depth, &smaller));
       if(depth){
@@ -0,0 +1,172 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "BuildContext.hpp"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+///Bit-packed L/S-Types and LMS-chars of a vector, built 64 positions at a time
+template<typename idxT=size_t>
+class LSTypeBits{
+   ///- bit i of *STypes* is set, if index i is S-Type, bit n (the empty suffix) is always set
+   ///- bit i of *LMS* is set, if index i is S-Type and index i-1 is L-Type, index 0 is never a LMS-char
+   ///
+   ///The type of an index depends on the type of the following index, if both chars are equal.
+   ///Inside of one word of 64 indices this is a carry running from the high bits to the low bits,
+   ///so it is resolved by a Kogge-Stone prefix with 6 shift-steps instead of 64 dependent bit-steps.
+public:
+   LSTypeBits() : n(0) {}
+
+   ///builds the types of *alph_cont*, they only depend on the order of the chars,
+   ///the bits are stored in buffers of *ctx*, if it is given
+   template<typename alph_cont_T>
+   explicit LSTypeBits(const std::vector<alph_cont_T>& alph_cont, BuildContext* ctx=nullptr)
+   : n(alph_cont.size()), STypes(takeBuffer<uint64_t>(ctx, words(n + 1), 0)), LMS(takeBuffer<uint64_t>(ctx, words(n + 1), 0))
+   {
+      if(!n){
+         STypes[0] = 1;
+         return;
+      }
+      ///1. walk the words from back to front, *carry* is the type of the first index of the following word
+      uint64_t carry = 1;
+      for(idxT w = STypes.size() - 1 ; w != idxT(-1) ; --w){
+         const idxT b = w << 6;
+         ///2. generate-bits(*lt*, index is S-Type because the next char is bigger) and propagate-bits(*eq*, index takes the type of the next index)
+         uint64_t lt = 0, eq = 0;
+         compareWord(alph_cont, b, lt, eq);
+         ///3. the last index has no successor and stays L-Type, the empty suffix is S-Type
+         if(n >= b && n < b + 64){
+            lt |= uint64_t(1) << (n - b);
+         }
+         ///4. inject the carry into bit 63 and resolve the chains of equal chars
+         lt |= eq & (carry << 63);
+         for(unsigned s = 1 ; s < 64 ; s <<= 1){
+            lt |= eq & (lt >> s);
+            eq &= eq >> s;
+         }
+         STypes[w] = lt;
+         carry = lt & 1;
+      }
+      ///5. a LMS-char is a S-Type with a L-Type in front, the index in front of 0 counts as S-Type
+      uint64_t prev = 1;
+      for(idxT w = 0 ; w < STypes.size() ; ++w){
+         LMS[w] = STypes[w] & ~((STypes[w] << 1) | prev);
+         prev = STypes[w] >> 63;
+      }
+   }
+
+   ///checks if an index is S-Type
+   bool isS(const idxT& i) const {
+      return (STypes[i >> 6] >> (i & 63)) & 1;
+   }
+
+   ///prefetches the word holding the type of index i
+   void prefetch(const idxT& i) const {
+      __builtin_prefetch(&STypes[i >> 6]);
+   }
+
+   ///checks if an index points to a LMS-char
+   bool isLMS(const idxT& i) const {
+      return (LMS[i >> 6] >> (i & 63)) & 1;
+   }
+
+   ///returns the first LMS-char behind index i (i < n), the empty suffix always is a LMS-char
+   idxT nextLMS(const idxT& i) const {
+      idxT w = (i + 1) >> 6;
+      uint64_t bits = LMS[w] & (~uint64_t(0) << ((i + 1) & 63));
+      while(!bits){
+         bits = LMS[++w];
+      }
+      return (w << 6) + __builtin_ctzll(bits);
+   }
+
+   ///calls *f* with every LMS-char in increasing order, the empty suffix is excluded
+   template<typename Func>
+   void forEachLMS(Func f) const {
+      for(idxT w = 0 ; w < LMS.size() ; ++w){
+         uint64_t bits = LMS[w];
+         while(bits){
+            const idxT i = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if(i < n){
+               f(i);
+            }
+         }
+      }
+   }
+
+   ///counts of the LMS-chars in front of every word of 64 indices, for *lmsRank*
+   std::vector<idxT> lmsDirectory() const {
+      std::vector<idxT> directory(LMS.size());
+      idxT count = 0;
+      for(idxT w = 0 ; w < LMS.size() ; ++w){
+         directory[w] = count;
+         count += __builtin_popcountll(LMS[w]);
+      }
+      return directory;
+   }
+
+   ///count of the LMS-chars in front of index i, *directory* is the result of *lmsDirectory*
+   idxT lmsRank(const idxT& i, const std::vector<idxT>& directory) const {
+      return directory[i >> 6] + __builtin_popcountll(LMS[i >> 6] & ((uint64_t(1) << (i & 63)) - 1));
+   }
+
+   ///bytes of the types and the LMS-bits
+   size_t bytes() const {
+      return (STypes.size() + LMS.size()) * sizeof(uint64_t);
+   }
+
+   ///hands the bits back to *ctx*
+   void release(BuildContext* ctx){
+      giveBuffer(ctx, STypes);
+      giveBuffer(ctx, LMS);
+      n = 0;
+   }
+
+private:
+   static idxT words(const idxT& bits){
+      return (bits + 63) >> 6;
+   }
+
+   ///sets bit k of *lt*/*eq*, if alph_cont[b+k] is smaller than/equal to alph_cont[b+k+1], the last index has no successor and stays 0
+   template<typename alph_cont_T>
+   static void compareWord(const std::vector<alph_cont_T>& alph_cont,
+                           const idxT& b,
+                           uint64_t& lt,
+                           uint64_t& eq){
+      const idxT e = std::min<idxT>(b + 64, alph_cont.size() - 1);
+      for(idxT i = b ; i < e ; ++i){
+         lt |= uint64_t(alph_cont[i] < alph_cont[i+1]) << (i - b);
+         eq |= uint64_t(alph_cont[i] == alph_cont[i+1]) << (i - b);
+      }
+   }
+
+#ifdef __SSE2__
+   ///unsigned bytes are compared 16 at a time, the sign-bit is flipped for the signed compare of SSE2
+   static void compareWord(const std::vector<unsigned char>& alph_cont,
+                           const idxT& b,
+                           uint64_t& lt,
+                           uint64_t& eq){
+      if(b + 65 > alph_cont.size()){
+         compareWord<unsigned char>(alph_cont, b, lt, eq);
+         return;
+      }
+      const __m128i flip = _mm_set1_epi8(char(0x80));
+      for(unsigned k = 0 ; k < 64 ; k += 16){
+         const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alph_cont.data() + b + k));
+         const __m128i nxt = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alph_cont.data() + b + k + 1));
+         const uint64_t l = unsigned(_mm_movemask_epi8(_mm_cmplt_epi8(_mm_xor_si128(cur, flip),
+                                                                      _mm_xor_si128(nxt, flip))));
+         const uint64_t q = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(cur, nxt)));
+         lt |= l << k;
+         eq |= q << k;
+      }
+   }
+#endif
+
+   idxT n;
+   std::vector<uint64_t> STypes;
+   std::vector<uint64_t> LMS;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+///Read-only memory-mapping of a whole file
+template<typename T=char>
+class MappedFile{
+   ///- the pages are loaded by the operating system on first access and can be dropped again under memory pressure,
+   ///so a mapped file can be bigger than the main memory
+   ///- the mapping is removed by the destructor
+   ///- a file, that is not *required*, may be missing, then *data* is a nullptr
+public:
+   explicit MappedFile(const std::string& f_name, const bool& required=true)
+   : fd(-1), bytes(0), ptr(nullptr)
+   {
+      fd = open(f_name.c_str(), O_RDONLY);
+      if(fd < 0 && !required)
+         return;
+      if(fd < 0){
+         std::cerr << "ERROR : Failed to open ''" << f_name << "'' for mapping\n";
+         exit(1);
+      }
+      struct stat st;
+      if(fstat(fd, &st) < 0){
+         std::cerr << "ERROR : Failed to get the size of ''" << f_name << "''\n";
+         exit(1);
+      }
+      bytes = st.st_size;
+      if(bytes){
+         void* m = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+         if(m == MAP_FAILED){
+            std::cerr << "ERROR : Failed to map ''" << f_name << "''\n";
+            exit(1);
+         }
+         ptr = static_cast<const T*>(m);
+      }
+   }
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   ~MappedFile(){
+      if(ptr)
+         munmap(const_cast<T*>(ptr), bytes);
+      if(fd >= 0)
+         close(fd);
+   }
+
+   ///tells the operating system, that the mapping is read sequentially(true) or randomly(false)
+   void advise(const bool& sequential) const {
+      if(ptr)
+         madvise(const_cast<T*>(ptr), bytes, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+   }
+
+   const T* data() const {
+      return ptr;
+   }
+
+   ///count of elements of type *T* in the file
+   size_t size() const {
+      return bytes / sizeof(T);
+   }
+
+private:
+   int fd;
+   size_t bytes;
+   const T* ptr;
+};
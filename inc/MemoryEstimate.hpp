@@ -0,0 +1,97 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+///Estimated peak memory of the suffix-array-engines, to choose the fastest engine, that fits into a memory-budget
+template<typename alph, typename idxT>
+class MemoryEstimate{
+   ///Every engine holds the input and the suffix-array, the working memory on top is measured as peak resident memory
+   ///of builds of 32MB-corpora (text, random and repetitive, see *Benchmark*) and stored per symbol
+   ///in sixteenths of an index plus bytes (e.g. *SuffixArrayInducedSorting*: 1.25 indices).
+   ///Alphabets wider than a byte add their dense ranks and the buckets of every symbol,
+   ///''-lcp'' adds the lcp-array and the two vectors of the lcp-lr-arrays of every suffix.
+   ///
+   ///The estimates are made from the size of the input-file, before the input is read,
+   ///so they are upper bounds for inputs with filtered newlines or UTF-8.
+public:
+   ///engine and its working memory per symbol
+   struct Engine{
+      std::string name;
+      unsigned sixteenths;
+      unsigned bytes;
+   };
+
+   ///constructor sets the count of symbols, the size of the alphabet and if the lcp-lr-arrays are built
+   MemoryEstimate(const uint64_t& symbol_count,
+                const uint64_t& alphabet_size,
+                const bool& lcp)
+   : n(symbol_count), sigma(alphabet_size), use_lcp(lcp)
+   {}
+
+   ///engines, that are chosen from, fastest first,
+   ///the naive engines are never chosen, they need quadratic time on repetitive inputs
+   static const std::vector<Engine>& engines(){
+      static const std::vector<Engine> e = {{"-is", 20, 0},
+                                            {"-isi", 0, 0},
+                                            {"-ts", 1, 0},
+                                            {"-isp", 42, 0},
+                                            {"-pd", 53, 0}};
+      return e;
+   }
+
+   ///estimated peak memory of *engine* in bytes
+   uint64_t peak(const Engine& engine) const {
+      uint64_t bytes = ProcessOverhead + n * sizeof(alph) + (n + 1) * sizeof(idxT);
+      bytes += n * engine.sixteenths * sizeof(idxT) / 16 + n * engine.bytes;
+      if(sizeof(alph) > 1)
+         bytes += n * sizeof(alph) + 3 * sigma * sizeof(idxT);
+      if(use_lcp)
+         bytes += (n + 1) * (sizeof(idxT) + 2 * (sizeof(std::vector<idxT>) + LCPAllocation));
+      return bytes;
+   }
+
+   ///memory of ''-em'' besides its memory-cap: the mapped input and the blocks of the file, that is sorted into runs
+   uint64_t external() const {
+      return ProcessOverhead + n * sizeof(alph) + ExternalBlocks * 3 * sizeof(idxT);
+   }
+
+   ///checks if *engine* can sort the input with indices of type *idxT*
+   bool usable(const Engine& engine) const {
+      ///*SuffixArrayTwoStage* marks entries with the highest bit of an index
+      return engine.name != "-ts" || n < (uint64_t(idxT(-1)) >> 1);
+   }
+
+   ///returns the fastest engine, whose estimated peak memory fits into *budget* bytes, an empty string, if none fits
+   std::string choose(const uint64_t& budget) const {
+      for(const Engine& e : engines()){
+         if(usable(e) && peak(e) <= budget)
+            return e.name;
+      }
+      return "";
+   }
+
+   ///writes the estimates of all engines in megabytes
+   void report(std::ostream& out) const {
+      out << "Estimated peak memory:";
+      for(const Engine& e : engines()){
+         if(usable(e))
+            out << ' ' << e.name << ' ' << ((peak(e) + (1 << 20) - 1) >> 20) << "MB";
+      }
+      out << '\n';
+   }
+
+private:
+   ///resident memory of the process besides the arrays (code, libraries, stack)
+   static const uint64_t ProcessOverhead = uint64_t(8) << 20;
+   ///heap-memory of a vector of the lcp-lr-arrays
+   static const uint64_t LCPAllocation = 48;
+   ///records of the blocks, that *SuffixArrayExternal* reads and writes besides its memory-cap
+   static const uint64_t ExternalBlocks = 2 << 12;
+
+   const uint64_t n;
+   const uint64_t sigma;
+   const bool use_lcp;
+};
@@ -0,0 +1,435 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include "BWTInducedSorting.hpp"
+#include "SuffixArraySparse.hpp"
+#include "MappedFile.hpp"
+
+///bits 3 and 7 of the header-byte together mark the manifest of a segmented index (''-app''),
+///a stored transform is never sparse, so no single suffix-array or transform uses both
+const unsigned char SegmentsHeaderBits = SparseHeaderBit | BWTHeaderBit;
+
+///checks if the header-byte of a stored file belongs to the manifest of a segmented index
+inline bool isSegmentedIndex(const unsigned char& header){
+   return (header & SegmentsHeaderBits) == SegmentsHeaderBits;
+}
+
+///Karp-Rabin fingerprints of strings, modulo the Mersenne-prime 2^61-1
+const uint64_t FingerprintPrime = (uint64_t(1) << 61) - 1;
+const uint64_t FingerprintBase = 0x1b873593a5c2e6dULL;
+///a segment stores the fingerprints of its prefixes, whose lengths are multiples of *FingerprintStep*
+const uint64_t FingerprintStep = 8;
+///marks the fingerprints behind the suffix-array of a segment
+const char FingerprintMarker[4] = {'K', 'R', 'F', 'P'};
+
+inline uint64_t fingerprintMul(const uint64_t& a, const uint64_t& b){
+   const unsigned __int128 p = (unsigned __int128)a * b;
+   const uint64_t r = (uint64_t(p) & FingerprintPrime) + uint64_t(p >> 61);
+   return r >= FingerprintPrime ? r - FingerprintPrime : r;
+}
+
+inline uint64_t fingerprintAdd(const uint64_t& a, const uint64_t& b){
+   const uint64_t r = a + b;
+   return r >= FingerprintPrime ? r - FingerprintPrime : r;
+}
+
+inline uint64_t fingerprintSub(const uint64_t& a, const uint64_t& b){
+   return a >= b ? a - b : a + FingerprintPrime - b;
+}
+
+///fingerprint of the string with the fingerprint *h*, that is extended by the symbol *c*
+inline uint64_t fingerprintExtend(const uint64_t& h, const uint64_t& c){
+   return fingerprintAdd(fingerprintMul(h, FingerprintBase), c);
+}
+
+///appends the fingerprints of the prefixes of *data* to the stored suffix-array of a segment
+template<typename alph>
+bool appendFingerprints(const std::string& f_name, const std::vector<alph>& data){
+   std::ofstream out(f_name, std::ios::binary | std::ios::app);
+   std::vector<uint64_t> prefixes;
+   prefixes.reserve(data.size() / FingerprintStep + 1);
+   uint64_t h = 0;
+   for(size_t i = 0 ; i < data.size() ; ++i){
+      if(i % FingerprintStep == 0)
+         prefixes.push_back(h);
+      h = fingerprintExtend(h, uint64_t(data[i]));
+   }
+   if(data.size() % FingerprintStep == 0)
+      prefixes.push_back(h);
+   const uint64_t count = prefixes.size();
+   out.write(FingerprintMarker, sizeof(FingerprintMarker));
+   out.write((const char*)&count, sizeof(count));
+   out.write((const char*)prefixes.data(), sizeof(uint64_t) * count);
+   out.close();
+   return bool(out);
+}
+
+///Manifest of an index, that grows by appending segments
+class SegmentManifest{
+   ///The manifest *index* lists the segments in the order of the text, every segment is a stored suffix-array
+   ///of its own text in *index*.*id*, followed by the fingerprints of its prefixes (see *appendFingerprints*). The file holds the header-byte (widths and *SegmentsHeaderBits*),
+   ///the next free id, the count of segments and the id and the count of symbols of every segment.
+   ///
+   ///Appends and merges change the manifest under the lock *index*.lock, they write it to *index*.part and rename it,
+   ///so a search reads the manifest without locking. A segment is built under an id, that is reserved
+   ///in the manifest before, and it is listed when it is complete. Merged segments are removed after the new
+   ///manifest is renamed, a search, that misses one of them, reads the manifest again.
+public:
+   struct Segment{
+      uint64_t id;
+      uint64_t size;
+   };
+
+   explicit SegmentManifest(const std::string& f_name)
+   : index(f_name), header(0), next_id(0)
+   {}
+
+   ///reads the manifest, false if it does not exist
+   bool read(){
+      std::ifstream in(index, std::ios::binary);
+      if(!in.is_open())
+         return false;
+      uint64_t count = 0;
+      in.read((char*)&header, sizeof(header));
+      in.read((char*)&next_id, sizeof(next_id));
+      in.read((char*)&count, sizeof(count));
+      segments.resize(count);
+      if(count)
+         in.read((char*)&segments[0], sizeof(Segment) * count);
+      if(!in || !isSegmentedIndex(header)){
+         std::cerr << "ERROR : ''" << index << "'' is no segmented index\n";
+         exit(1);
+      }
+      return true;
+   }
+
+   void write() const {
+      const std::string part = index + ".part";
+      std::ofstream out(part, std::ios::binary);
+      const uint64_t count = segments.size();
+      out.write((const char*)&header, sizeof(header));
+      out.write((const char*)&next_id, sizeof(next_id));
+      out.write((const char*)&count, sizeof(count));
+      if(count)
+         out.write((const char*)&segments[0], sizeof(Segment) * count);
+      out.close();
+      if(!out || std::rename(part.c_str(), index.c_str())){
+         std::cerr << "ERROR : Failed to write the manifest ''" << index << "''\n";
+         exit(1);
+      }
+   }
+
+   ///sets the widths of a new manifest, *width_codes* are the width-bits of the header-byte of its segments
+   void create(const unsigned char& width_codes){
+      header = width_codes | SegmentsHeaderBits;
+      next_id = 0;
+      segments.clear();
+   }
+
+   ///reserves the id of a new segment
+   uint64_t reserve(){
+      return next_id++;
+   }
+
+   void append(const uint64_t& id, const uint64_t& size){
+      segments.push_back(Segment{id, size});
+   }
+
+   ///replaces the neighbouring segments *first* and *first*+1 by segment *id*
+   void replace(const size_t& first, const uint64_t& id){
+      segments[first].size += segments[first + 1].size;
+      segments[first].id = id;
+      segments.erase(segments.begin() + first + 1);
+   }
+
+   ///first of the two neighbouring segments, that are merged next, the size of the segments is not balanced,
+   ///if a segment is less than *MergeRatio* times bigger than the segment behind it.
+   ///The last pair is taken first, so the sizes decrease geometrically and every symbol is merged O(log n) times.
+   ///Merged segments must have less than *max_size* symbols, returns the count of segments, if no pair is merged.
+   size_t nextMerge(const uint64_t& max_size) const {
+      for(size_t s = segments.size() ; s-- > 1 ; ){
+         if(segments[s-1].size < MergeRatio * segments[s].size && segments[s-1].size + segments[s].size < max_size)
+            return s - 1;
+      }
+      return segments.size();
+   }
+
+   ///index of the segment *id*, the count of segments if it is not listed
+   size_t find(const uint64_t& id) const {
+      size_t s = 0;
+      while(s < segments.size() && segments[s].id != id)
+         ++s;
+      return s;
+   }
+
+   std::string segmentName(const uint64_t& id) const {
+      std::stringstream buf;
+      buf << index << '.' << id;
+      return buf.str();
+   }
+
+   const std::vector<Segment>& list() const {
+      return segments;
+   }
+
+   unsigned char headerByte() const {
+      return header;
+   }
+
+private:
+   static const uint64_t MergeRatio = 2;
+
+   const std::string index;
+   unsigned char header;
+   uint64_t next_id;
+   std::vector<Segment> segments;
+};
+
+///exclusive lock of a file, that is held until the object is destroyed
+class FileLock{
+public:
+   explicit FileLock(const std::string& f_name)
+   : fd(open(f_name.c_str(), O_RDWR | O_CREAT, 0644))
+   {
+      if(fd < 0 || flock(fd, LOCK_EX)){
+         std::cerr << "ERROR : Failed to lock ''" << f_name << "''\n";
+         exit(1);
+      }
+   }
+
+   FileLock(const FileLock&) = delete;
+   FileLock& operator=(const FileLock&) = delete;
+
+   ~FileLock(){
+      flock(fd, LOCK_UN);
+      close(fd);
+   }
+
+private:
+   const int fd;
+};
+
+///Read-only view of the mapped segments of a segmented index
+template<typename alph, typename idxT>
+class SegmentView{
+   ///The text, the suffix-array and the fingerprints of every segment are read from its mapping,
+   ///so a search only loads the pages, that it touches.
+   ///
+   ///Two suffixes of the whole text are compared behind their longest common prefix. The first *DirectScan* symbols
+   ///are compared directly, a longer prefix is found by galloping and binary search over the fingerprints of the prefixes
+   ///of the whole text, so a comparison takes O(log n) steps, even if the suffixes share most of a repetitive text.
+   ///Different strings with equal fingerprints are possible, the probability is below n/2^61 for every test.
+public:
+   ///maps the segments of *manifest*, false if one of them is missing (a merge removed it in between)
+   bool open(const SegmentManifest& manifest){
+      parts.clear();
+      offsets.assign(1, 0);
+      for(const SegmentManifest::Segment& seg : manifest.list()){
+         parts.emplace_back();
+         Part& part = parts.back();
+         const std::string f_name = manifest.segmentName(seg.id);
+         part.file.reset(new MappedFile<char>(f_name, false));
+         if(!part.file->data())
+            return false;
+         const size_t text = 1 + sizeof(idxT);
+         const size_t sa = text + seg.size * sizeof(alph);
+         const size_t fp = sa + (seg.size + 1) * sizeof(idxT) + sizeof(bool);
+         const uint64_t count = seg.size / FingerprintStep + 1;
+         idxT stored = 0;
+         if(part.file->size() >= text)
+            memcpy(&stored, part.file->data() + 1, sizeof(idxT));
+         if(part.file->size() != fp + sizeof(FingerprintMarker) + sizeof(uint64_t) + count * sizeof(uint64_t)
+            || uint64_t(stored) != seg.size
+            || memcmp(part.file->data() + fp, FingerprintMarker, sizeof(FingerprintMarker))){
+            std::cerr << "ERROR : The segment ''" << f_name << "'' is damaged or was built without fingerprints\n";
+            exit(1);
+         }
+         part.text = part.file->data() + text;
+         part.sa = part.file->data() + sa;
+         part.prefixes = part.file->data() + fp + sizeof(FingerprintMarker) + sizeof(uint64_t);
+         offsets.push_back(offsets.back() + seg.size);
+      }
+      ///powers of the base, split into the low and the high 16 bits of the exponent
+      low_powers.resize(uint64_t(1) << 16);
+      low_powers[0] = 1;
+      for(size_t i = 1 ; i < low_powers.size() ; ++i)
+         low_powers[i] = fingerprintMul(low_powers[i-1], FingerprintBase);
+      const uint64_t high_step = fingerprintMul(low_powers.back(), FingerprintBase);
+      high_powers.resize((size() >> 16) + 1);
+      high_powers[0] = 1;
+      for(size_t i = 1 ; i < high_powers.size() ; ++i)
+         high_powers[i] = fingerprintMul(high_powers[i-1], high_step);
+      ///fingerprints of the text in front of every segment
+      starts.assign(parts.size() + 1, 0);
+      for(size_t s = 0 ; s < parts.size() ; ++s)
+         starts[s+1] = fingerprintAdd(fingerprintMul(starts[s], power(length(s))), localPrefix(s, length(s)));
+      return true;
+   }
+   
+   ///count of segments
+   size_t count() const {
+      return parts.size();
+   }
+   
+   ///count of symbols of the whole text
+   uint64_t size() const {
+      return offsets.back();
+   }
+   
+   ///position of the first symbol of segment *s* in the whole text
+   uint64_t offset(const size_t& s) const {
+      return offsets[s];
+   }
+   
+   uint64_t length(const size_t& s) const {
+      return offsets[s+1] - offsets[s];
+   }
+   
+   ///symbol *i* of segment *s*
+   alph symbol(const size_t& s, const uint64_t& i) const {
+      alph c;
+      memcpy(&c, parts[s].text + i * sizeof(alph), sizeof(alph));
+      return c;
+   }
+   
+   ///position in segment *s* of the suffix of rank *r* in its suffix-array
+   uint64_t suffix(const size_t& s, const uint64_t& r) const {
+      idxT i;
+      memcpy(&i, parts[s].sa + r * sizeof(idxT), sizeof(idxT));
+      return uint64_t(i);
+   }
+   
+   ///symbol *p* of the whole text
+   alph operator[](const uint64_t& p) const {
+      const size_t s = segmentOf(p);
+      return symbol(s, p - offsets[s]);
+   }
+   
+   ///first rank of segment *s*, whose suffix (ending at the end of the segment) is not smaller than *infix*
+   uint64_t lowerBound(const size_t& s, const std::vector<alph>& infix) const {
+      uint64_t lo = 0, hi = length(s) + 1;
+      while(lo < hi){
+         const uint64_t mid = lo + (hi - lo) / 2;
+         const uint64_t i = suffix(s, mid);
+         uint64_t j = 0;
+         while(j < infix.size() && i + j < length(s) && symbol(s, i + j) == infix[j])
+            ++j;
+         if(j < infix.size() && (i + j == length(s) || symbol(s, i + j) < infix[j]))
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+      return lo;
+   }
+   
+   ///checks if *infix* starts at position *i* of segment *s* and ends inside of it
+   bool startsWith(const size_t& s, const uint64_t& i, const std::vector<alph>& infix) const {
+      if(i + infix.size() > length(s))
+         return false;
+      for(uint64_t j = 0 ; j < infix.size() ; ++j){
+         if(symbol(s, i + j) != infix[j])
+            return false;
+      }
+      return true;
+   }
+   
+   ///checks if the suffix *a* of the whole text is smaller than the suffix *b*, both share their first *from* symbols
+   bool less(const uint64_t& a, const uint64_t& b, const uint64_t& from) const {
+      const uint64_t l = lcp(a, b, from, std::min(size() - a, size() - b));
+      if(l == size() - a)
+         return a != b;
+      if(l == size() - b)
+         return false;
+      return (*this)[a + l] < (*this)[b + l];
+   }
+   
+   ///length of the longest common prefix of the suffixes *a* and *b* of the whole text, but at most *limit*,
+   ///both share their first *from* symbols
+   uint64_t lcp(const uint64_t& a, const uint64_t& b, const uint64_t& from, const uint64_t& limit) const {
+      uint64_t l = from;
+      const uint64_t direct = std::min(limit, from + DirectScan);
+      while(l < direct && (*this)[a + l] == (*this)[b + l])
+         ++l;
+      if(l < direct || l == limit)
+         return l;
+      const uint64_t ha = prefix(a);
+      const uint64_t hb = prefix(b);
+      auto equal = [&](const uint64_t& len){
+         const uint64_t pw = power(len);
+         return fingerprintSub(prefix(a + len), fingerprintMul(ha, pw)) == fingerprintSub(prefix(b + len), fingerprintMul(hb, pw));
+      };
+      ///suffixes of a repetitive text often share all symbols up to the end of the shorter one
+      if(equal(limit))
+         return limit;
+      ///the first *good* symbols are equal, the first *bad* symbols are not
+      uint64_t good = l, bad = limit;
+      for(uint64_t step = DirectScan ; good + step < limit ; step <<= 1){
+         if(!equal(good + step)){
+            bad = good + step;
+            break;
+         }
+         good += step;
+      }
+      while(bad - good > DirectScan){
+         const uint64_t mid = good + (bad - good) / 2;
+         if(equal(mid))
+            good = mid;
+         else
+            bad = mid;
+      }
+      while(good < bad && (*this)[a + good] == (*this)[b + good])
+         ++good;
+      return good;
+   }
+   
+private:
+   static const uint64_t DirectScan = 64;
+   
+   struct Part{
+      std::unique_ptr<MappedFile<char>> file;
+      const char* text;
+      const char* sa;
+      const char* prefixes;
+   };
+   
+   size_t segmentOf(const uint64_t& p) const {
+      return std::min<size_t>(std::upper_bound(offsets.begin(), offsets.end(), p) - offsets.begin() - 1, parts.size() - 1);
+   }
+   
+   uint64_t power(const uint64_t& e) const {
+      return fingerprintMul(high_powers[e >> 16], low_powers[e & 0xFFFF]);
+   }
+   
+   ///fingerprint of the first *i* symbols of segment *s*
+   uint64_t localPrefix(const size_t& s, const uint64_t& i) const {
+      uint64_t h;
+      memcpy(&h, parts[s].prefixes + (i / FingerprintStep) * sizeof(uint64_t), sizeof(uint64_t));
+      for(uint64_t j = i - i % FingerprintStep ; j < i ; ++j)
+         h = fingerprintExtend(h, uint64_t(symbol(s, j)));
+      return h;
+   }
+   
+   ///fingerprint of the first *p* symbols of the whole text
+   uint64_t prefix(const uint64_t& p) const {
+      const size_t s = segmentOf(p);
+      const uint64_t i = p - offsets[s];
+      return fingerprintAdd(fingerprintMul(starts[s], power(i)), localPrefix(s, i));
+   }
+   
+   std::vector<Part> parts;
+   std::vector<uint64_t> offsets;
+   std::vector<uint64_t> starts;
+   std::vector<uint64_t> low_powers;
+   std::vector<uint64_t> high_powers;
+};
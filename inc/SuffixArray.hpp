@@ -5,12 +5,48 @@
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <iterator>
+#include <queue>
 #include "SuffixArrayInducedSorting_bu0.hpp"
 // #include "SuffixArrayInducedSorting.hpp"
+#include "SuffixArrayInducedSortingInPlace.hpp"
+#include "SuffixArrayInducedSortingParallel.hpp"
+#include "SuffixArrayTwoStage.hpp"
+#include "SuffixArrayPrefixDoubling.hpp"
 #include "SuffixArrayNaive.hpp"
+#include "SuffixArrayExternal.hpp"
+#include "SuffixArrayChunked.hpp"
+#include "BWTInducedSorting.hpp"
+#include "SuffixArraySparse.hpp"
+#include "DocumentCollection.hpp"
+#include "SegmentedIndex.hpp"
+#include "MappedFile.hpp"
+#include "TokenSuffixArray.hpp"
+#include "Utf8.hpp"
 #include "parseModes.hpp"
 #include "typeChecks.hpp"
+#include "IndexTypes.hpp"
 #include "LCPArrayNaive.hpp"
+#include "BuildStats.hpp"
+#include "MemoryEstimate.hpp"
+#include "BuildCheckpoint.hpp"
+#include <functional>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <limits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+#include "tbb/parallel_for.h"
 
 template<typename alph=char, typename idxT=size_t>
 class SuffixArray;
@@ -34,54 +70,90 @@ public:
    
    
    SuffixArray(const Modes& modes){
+      if(modes["Merge"].size()){
+         mergeSegments(modes, modes["Merge"]);
+         return;
+      }
+      if(modes["Append"].size())
+         checkSegments(modes);
+      if(parse_flag(modes["BWT"]))
+         checkBWT(modes);
+      if(modes["Sparse"].size())
+         checkSparse(modes);
+      if(parse_flag(modes["Documents"]))
+         checkDocuments(modes);
+      if(modes["Stats"].size())
+         setStats(modes);
+      std::string cap = modes["MemoryCap"];
+      const std::string algorithm = modes["MemoryBudget"].size() ? chooseAlgorithm(modes, cap) : modes["Algorithm"];
+      if(algorithm == ExternalMemory){
+         external(modes, cap);
+         return;
+      }
+      if(modes["Chunks"].size())
+         setChunks(modes);
+      if(parse_flag(modes["Checkpoint"]) || parse_flag(modes["Resume"]))
+         setCheckpoint(modes, algorithm);
+      if(parse_flag(modes["ReadAhead"]) && algorithm != InducedSorting){
+         std::cerr << "ERROR : ''-ra'' needs ''-is''\n";
+         exit(1);
+      }
+      if(parse_flag(modes["Tokens"]) && (parse_flag(modes["useLCP"]) || parse_flag(modes["TryCompression"]) || chunks > 1)){
+         std::cerr << "ERROR : ''-tok'' can not be used with ''-lcp'', ''-tc'' or ''-ch''\n";
+         exit(1);
+      }
       std::vector<alph> data;
       idxT min = -1;
       idxT max = 0;
-      if(!read_data(modes["InFile"], 
-                data, 
-                parse_flag(modes["FilterNewline"]), 
-                min, 
-                max)){
+      if(parse_flag(modes["Documents"]) ? !read_documents(modes["InFile"], 
+                                                          data, 
+                                                          parse_flag(modes["FilterNewline"]), 
+                                                          parse_flag(modes["UTF8"]), 
+                                                          min, 
+                                                          max) 
+                                        : !read_data(modes["InFile"], 
+                                                     data, 
+                                                     parse_flag(modes["FilterNewline"]), 
+                                                     parse_flag(modes["UTF8"]), 
+                                                     min, 
+                                                     max)){
          std::cerr << "ERROR : Failed to read input-corpus-file\n";
          exit(1);
       }
-      
-      if(modes["Algorithm"] == Naive){
-         init<SuffixArrayNaive<alph,idxT>>
+      if(modes["Sparse"].size()){
+         const std::string rule = modes["Sparse"];
+         init<SuffixArraySparse<alph,idxT>>
              (modes["OutFile"], 
               modes["Infix"], 
-              SuffixArrayNaive<alph,
-                                idxT>(false),
-              parse_flag(modes["useLCP"]),
+              SuffixArraySparse<alph,
+                                idxT>(sparseSampling(rule), is_number(rule) ? std::stoull(rule) : 1),
+              false,
               modes["SubstringWidth"],
-              parse_flag(modes["TryCompression"]),
+              false,
               data,
               max);
+         return;
       }
-      else if(modes["Algorithm"] == NaiveParallel){
-         init<SuffixArrayNaive<alph,idxT>>
-             (modes["OutFile"], 
-              modes["Infix"], 
-              SuffixArrayNaive<alph,
-                                idxT>(),
-              parse_flag(modes["useLCP"]),
-              modes["SubstringWidth"],
-              parse_flag(modes["TryCompression"]),
-              data,
-              max);
+      ///the engines allocate buckets for every symbol between min and max, so sparse wide alphabets are sorted by their ranks
+      if(uint64_t(max) - uint64_t(min) >= DenseAlphabet && uint64_t(max) - uint64_t(min) >= data.size()){
+         denseRanks(data, min, max);
       }
-      else{
-         init<SuffixArrayInducedSorting<alph,idxT>>
-             (modes["OutFile"], 
-              modes["Infix"], 
-              SuffixArrayInducedSorting<alph,
-                                idxT>(min),
-              parse_flag(modes["useLCP"]),
-              modes["SubstringWidth"],
-              parse_flag(modes["TryCompression"]),
-              data,
-              max);
+      
+      if(parse_flag(modes["BWT"])){
+         bwt(modes["OutFile"], data, min, max);
+         return;
+      }
+      
+      if(parse_flag(modes["Tokens"])){
+         tokens(modes["OutFile"], modes["Infix"], modes["SubstringWidth"], data);
+         return;
+      }
+      
+      if(modes["Append"].size()){
+         append(modes, algorithm, data, min, max);
+         return;
       }
+      buildWith(modes, algorithm, modes["OutFile"], data, min, max);
    }
    /*
    SuffixArray(const std::string& f_name, 
@@ -103,15 +175,30 @@ public:
            parse_flag(fn));
    }*/
    
+   ///finds *infix* in a stored suffix-array, prints the matches and returns their range in the suffix-array.
+   ///If it indexes a document collection (''-docs''), *matches* gets the document and the offset inside of it
+   ///of every match in the order of the suffix-array
    std::pair<idxT,idxT> findInfixInF(const std::string& infix, 
                                      const std::string& f_name,
-                                     const std::string& sw) const {
+                                     const std::string& sw,
+                                     std::vector<std::pair<idxT,idxT>>* matches=nullptr) const {
+      if(isSegmentedIndex(headerOfStored(f_name))){
+         std::cerr << "ERROR : ''" << f_name << "'' holds a segmented index, it is searched by *findInSegmentsInF*\n";
+         exit(1);
+      }
+      if(headerOfStored(f_name) & BWTHeaderBit){
+         std::cerr << "ERROR : ''" << f_name << "'' holds a Burrows-Wheeler-transform, it can not be searched\n";
+         exit(1);
+      }
+      if(headerOfStored(f_name) & TokenHeaderBit)
+         return findTokensInF(infix, f_name, sw);
       std::vector<alph> data;
       std::vector<idxT> SA;
       std::vector<std::vector<idxT>> lcp_l;
       std::vector<std::vector<idxT>> lcp_r;
+      DocumentBoundaries<idxT> docs;
       
-      if(read(data, SA, lcp_l, lcp_r, f_name)){
+      if(read(data, SA, lcp_l, lcp_r, f_name, &docs)){
          
          std::pair<idxT,idxT> range = find_all_infix(infix, data, SA, lcp_l, lcp_r);
          
@@ -121,7 +208,12 @@ public:
          }
          else{
             std::cout << infix << "'':\n";
-            print_range(range, SA, data, sw);
+            print_range(range, SA, data, sw, docs.count() ? &docs : nullptr);
+         }
+         if(matches && docs.count()){
+            matches->clear();
+            for(idxT i = range.first ; i < range.second ; ++i)
+               matches->push_back(docs.locate(SA[i]));
          }
          
          return range;
@@ -132,8 +224,734 @@ public:
       }
    }
    
+   ///finds *infix* in the segments of a segmented index (''-app''), the range and the order of the matches
+   ///are the ones of the suffix-array of the whole text, positions and ranks are counted in the whole text
+   std::pair<uint64_t,uint64_t> findInSegmentsInF(const std::string& infix_in, 
+                                                  const std::string& index,
+                                                  const std::string& sw) const {
+      const std::vector<alph> infix = patternSymbols(infix_in);
+      const uint64_t m = infix.size();
+      if(!m){
+         std::cerr << "ERROR : The pattern is empty\n";
+         exit(1);
+      }
+      ///1. every segment is searched on its own text, its matches and its suffixes smaller than *infix* are counted
+      SegmentManifest manifest(index);
+      SegmentView<alph,idxT> text;
+      for(unsigned attempt = 0 ; ; ++attempt){
+         if(!manifest.read()){
+            std::cerr << "ERROR while reading ''" << index << "''\n";
+            exit(1);
+         }
+         if(text.open(manifest))
+            break;
+         ///a merge removed segments of the manifest, that was read
+         if(attempt == SegmentRetries){
+            std::cerr << "ERROR : The segments of ''" << index << "'' could not be read\n";
+            exit(1);
+         }
+      }
+      const size_t k = text.count();
+      std::vector<uint64_t> below(k);
+      ///the matches of every segment in the order of its suffix-array, behind them the matches, that cross a segment-end
+      std::vector<std::vector<uint64_t>> found(k + 1);
+      tbb::parallel_for(size_t(0), k, [&](const size_t& s){
+         uint64_t r = text.lowerBound(s, infix);
+         ///the empty suffix of a segment is no suffix of the whole text
+         below[s] = r - 1;
+         for( ; r <= text.length(s) && text.startsWith(s, text.suffix(s, r), infix) ; ++r)
+            found[s].push_back(text.offset(s) + text.suffix(s, r));
+      });
+      
+      ///2. a suffix shorter than *infix* near the end of a segment, which is a prefix of *infix*, was counted as smaller,
+      ///the next m-1 symbols of the whole text decide, if it is smaller, a match or bigger
+      uint64_t lower = 1;
+      for(size_t s = 0 ; s < k ; ++s)
+         lower += below[s];
+      for(size_t s = 0 ; s + 1 < k ; ++s){
+         const uint64_t end = text.offset(s + 1);
+         for(uint64_t i = std::max(text.offset(s), end - std::min(end, m - 1)) ; i < end ; ++i){
+            uint64_t d = 0;
+            while(d < m && i + d < text.size() && text[i + d] == infix[d])
+               ++d;
+            if(i + d < end)
+               continue;
+            if(d == m){
+               --lower;
+               found[k].push_back(i);
+            }
+            else if(i + d < text.size() && infix[d] < text[i + d])
+               --lower;
+         }
+      }
+      
+      ///3. the order of a suffix-array of a segment is the order of the whole text, unless a comparison reached the end
+      ///of the segment. Then the shorter suffix was taken as smaller, so it can only stand too early in the list.
+      ///A stack keeps the matches in order and moves the ones, that stand too early, to a list of their own,
+      ///which is sorted (it holds matches near the end of the segment). The lists are merged by a heap, 
+      ///so only matches of different lists are compared.
+      auto less = [&](const uint64_t& a, const uint64_t& b){
+         return text.less(a, b, m);
+      };
+      found.resize(2 * k + 1);
+      tbb::parallel_for(size_t(0), k + 1, [&](const size_t& s){
+         std::vector<uint64_t>& kept = found[s];
+         std::vector<uint64_t>& moved = s < k ? found[k + 1 + s] : found[k];
+         if(s < k){
+            size_t top = 0;
+            for(size_t i = 0 ; i < kept.size() ; ++i){
+               const uint64_t x = kept[i];
+               while(top && less(x, kept[top - 1]))
+                  moved.push_back(kept[--top]);
+               kept[top++] = x;
+            }
+            kept.resize(top);
+         }
+         std::sort(moved.begin(), moved.end(), less);
+      });
+      typedef std::pair<size_t,size_t> Head;
+      auto later = [&](const Head& x, const Head& y){
+         return less(found[y.first][y.second], found[x.first][x.second]);
+      };
+      std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+      for(size_t s = 0 ; s < found.size() ; ++s){
+         if(found[s].size())
+            heads.push(Head(s, 0));
+      }
+      std::vector<uint64_t> matches;
+      while(!heads.empty()){
+         Head h = heads.top();
+         heads.pop();
+         matches.push_back(found[h.first][h.second]);
+         if(++h.second < found[h.first].size())
+            heads.push(h);
+      }
+      
+      std::cout << "Pattern ''";
+      if(matches.empty()){
+         std::cout << infix_in << "'' Not Found\n";
+         return std::pair<uint64_t,uint64_t>(text.size() + 1, text.size() + 1);
+      }
+      std::cout << infix_in << "'':\n";
+      print_matches(lower, lower + matches.size(), matches.data(), text, sw);
+      return std::pair<uint64_t,uint64_t>(lower, lower + matches.size());
+   }
+   
    
 private:
+   ///builds the suffix-array from disk, without holding the input and the suffix-array in memory, 
+   ///*cap* is the memory-cap in megabytes
+   void external(const Modes& modes, const std::string& cap) const {
+      if(modes["Infix"].size() || parse_flag(modes["useLCP"]) || modes["Chunks"].size() || parse_flag(modes["Tokens"]) || parse_flag(modes["UTF8"])){
+         std::cerr << "ERROR : ''-em'' only writes the suffix-array, it can not be used with ''-f'', ''-lcp'', ''-ch'', ''-tok'' or ''-utf8''\n";
+         exit(1);
+      }
+      if(!is_number(cap) || !std::stoull(cap)){
+         std::cerr << "ERROR : memory-cap ''" << cap << "'' is no positive count of megabytes\n";
+         exit(1);
+      }
+      SuffixArrayExternal<alph,idxT> SuffixArrayAlgorithm(modes["TempDir"], 
+                                                          std::stoull(cap) << 20);
+      SuffixArrayAlgorithm(modes["InFile"], 
+                           parse_flag(modes["FilterNewline"]), 
+                           modes["OutFile"], 
+                           parse_flag(modes["TryCompression"]));
+      std::cout << "Data wrote to " << modes["OutFile"] << '\n';
+   }
+   
+   ///builds the suffix-array of the tokens of *data*, then finds the phrase *infix* or writes the suffix-array to *out_f*
+   void tokens(const std::string& out_f,
+               const std::string& infix,
+               const std::string& sw,
+               const std::vector<alph>& data) const {
+      checkIndexType<idxT>();
+      checkDataSizeIdxT<idxT>(data.size());
+      if(sizeof(alph) != 1){
+         std::cerr << "ERROR : ''-tok'' needs an alphabet of bytes\n";
+         exit(1);
+      }
+      TokenSuffixArray<alph,idxT> TSA;
+      TSA.build(data);
+      if(infix.size()){
+         print_phrase(infix, TSA.find(infix, data), TSA.suffixArray(), data, sw);
+      }
+      else{
+         std::ofstream out(out_f, std::ios::binary);
+         idxT data_size = data.size();
+         unsigned char header = TokenHeaderBit | (indexWidthCode<idxT>() << 4);
+         out.write((char*)&header, sizeof(header));
+         out.write((char*)&data_size, sizeof(idxT));
+         out.write((char*)(&(*(data.begin()))), sizeof(alph) * data_size);
+         TSA.write(out);
+         out.close();
+         std::cout << "Data wrote to " << out_f << '\n';
+      }
+   }
+   
+   ///''-bwt'' only builds and writes the transform, so the options of the suffix-array can not be used with it
+   void checkBWT(const Modes& modes) const {
+      if(modes["Infix"].size() || parse_flag(modes["useLCP"]) || parse_flag(modes["TryCompression"]) || parse_flag(modes["Tokens"]) 
+         || modes["Chunks"].size() || modes["MemoryBudget"].size() || parse_flag(modes["Checkpoint"]) || parse_flag(modes["Resume"]) 
+         || modes["Algorithm"] != InducedSorting){
+         std::cerr << "ERROR : ''-bwt'' only writes the transform, it can not be used with ''-f'', ''-lcp'', ''-tc'', ''-tok'', ''-ch'', "
+                   << "''-mb'', ''-cp'', ''-resume'' or an algorithm\n";
+         exit(1);
+      }
+   }
+   
+   ///''-docs'' reads the documents listed in the input-file, the options, that read or tag the input-file themselves, can not be used with it
+   void checkDocuments(const Modes& modes) const {
+      if(parse_flag(modes["TryCompression"]) || parse_flag(modes["Tokens"]) || parse_flag(modes["BWT"]) || modes["Sparse"].size()
+         || modes["Chunks"].size() || modes["MemoryBudget"].size() || parse_flag(modes["Checkpoint"]) || parse_flag(modes["Resume"]) 
+         || modes["Algorithm"] == ExternalMemory){
+         std::cerr << "ERROR : ''-docs'' can not be used with ''-tc'', ''-tok'', ''-bwt'', ''-sp'', ''-ch'', "
+                   << "''-mb'', ''-cp'', ''-resume'' or ''-em''\n";
+         exit(1);
+      }
+   }
+   
+   ///''-app'' builds every segment with an algorithm of the plain suffix-array, so the options, that change the stored file
+   ///or build in their own way, can not be used with it
+   void checkSegments(const Modes& modes) const {
+      if(modes["Infix"].size() || parse_flag(modes["useLCP"]) || parse_flag(modes["TryCompression"]) || parse_flag(modes["Tokens"]) 
+         || parse_flag(modes["BWT"]) || modes["Sparse"].size() || parse_flag(modes["Documents"]) || modes["Chunks"].size() 
+         || modes["MemoryBudget"].size() || parse_flag(modes["Checkpoint"]) || parse_flag(modes["Resume"]) || modes["Stats"].size()
+         || modes["Algorithm"] == ExternalMemory){
+         std::cerr << "ERROR : ''-app'' can not be used with ''-f'', ''-lcp'', ''-tc'', ''-tok'', ''-bwt'', ''-sp'', ''-docs'', "
+                   << "''-ch'', ''-mb'', ''-cp'', ''-resume'', ''-st'' or ''-em''\n";
+         exit(1);
+      }
+   }
+   
+   ///appends *data* as a new segment to the segmented index *modes["Append"]*, then starts merging its segments
+   void append(const Modes& modes,
+               const std::string& algorithm,
+               const std::vector<alph>& data,
+               const idxT& min,
+               const idxT& max){
+      const std::string index = modes["Append"];
+      const unsigned char widths = (alphabetWidthCode<alph>() << 1) | (indexWidthCode<idxT>() << 4);
+      SegmentManifest manifest(index);
+      uint64_t id;
+      {
+         FileLock lock(index + ".lock");
+         if(!manifest.read())
+            manifest.create(widths);
+         if(manifest.headerByte() != (widths | SegmentsHeaderBits)){
+            std::cerr << "ERROR : The segments of ''" << index << "'' have other symbol- or index-widths\n";
+            exit(1);
+         }
+         id = manifest.reserve();
+         manifest.write();
+      }
+      buildWith(modes, algorithm, manifest.segmentName(id), data, min, max);
+      if(!appendFingerprints(manifest.segmentName(id), data)){
+         std::cerr << "ERROR : Failed to write the segment ''" << manifest.segmentName(id) << "''\n";
+         exit(1);
+      }
+      {
+         FileLock lock(index + ".lock");
+         manifest.read();
+         manifest.append(id, data.size());
+         manifest.write();
+      }
+      std::cout << "Appended segment " << id << " to " << index << '\n';
+      startMerge(index, algorithm);
+   }
+   
+   ///runs ''-merge'' for *index* in a detached process, so the append returns before the segments are merged.
+   ///The process is started from the executable of the caller, as the threads of the build are not copied by *fork*.
+   ///It keeps none of the streams of the caller, its errors are written to *index*''.merge.log''.
+   ///A failed start is reported by the caller, a failed merge leaves the segments unmerged.
+   static void startMerge(const std::string& index, const std::string& algorithm){
+      const std::string exe = executablePath();
+      ///the merging process writes the error of a failed *exec* into the pipe, a successful *exec* closes it
+      int failed[2];
+      if(exe.empty() || pipe(failed)){
+         std::cerr << "WARNING : Failed to start merging the segments of ''" << index << "''\n";
+         return;
+      }
+      fcntl(failed[1], F_SETFD, FD_CLOEXEC);
+      const pid_t pid = fork();
+      if(pid < 0){
+         close(failed[0]);
+         close(failed[1]);
+         std::cerr << "WARNING : Failed to start merging the segments of ''" << index << "''\n";
+         return;
+      }
+      if(!pid){
+         close(failed[0]);
+         ///the process in between exits at once, so the merging process is no child of the caller
+         if(!fork()){
+            setsid();
+            const int null = open("/dev/null", O_RDWR);
+            const int log = open((index + ".merge.log").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            dup2(null, STDIN_FILENO);
+            dup2(null, STDOUT_FILENO);
+            dup2(log < 0 ? null : log, STDERR_FILENO);
+            execl(exe.c_str(), "SuffixArray", Merge.c_str(), index.c_str(), algorithm.c_str(), (char*)nullptr);
+            const int error = errno;
+            if(::write(failed[1], &error, sizeof(error))){}
+            _exit(1);
+         }
+         _exit(0);
+      }
+      close(failed[1]);
+      waitpid(pid, nullptr, 0);
+      int error;
+      if(::read(failed[0], &error, sizeof(error)) == sizeof(error)){
+         std::cerr << "WARNING : Failed to start merging the segments of ''" << index << "'' (" << exe << " : "
+                   << std::strerror(error) << ")\n";
+      }
+      close(failed[0]);
+   }
+   
+   ///path of the running executable, empty if it is unknown
+   static std::string executablePath(){
+#ifdef __APPLE__
+      uint32_t size = 0;
+      _NSGetExecutablePath(nullptr, &size);
+      std::string path(size, '\0');
+      if(_NSGetExecutablePath(&path[0], &size))
+         return "";
+      path.resize(std::strlen(path.c_str()));
+      return path;
+#else
+      char path[PATH_MAX];
+      const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+      return length > 0 ? std::string(path, length) : std::string();
+#endif
+   }
+   
+   ///merges neighbouring segments of the segmented index *index*, until their sizes are balanced (see *SegmentManifest*).
+   ///A merged segment is built from the text of both segments with the algorithm of *modes*, so it is the suffix-array of its text.
+   ///The manifest is locked only to reserve the id of the merged segment and to list it, appends go on while it is built.
+   void mergeSegments(const Modes& modes, const std::string& index){
+      if(modes["Algorithm"] == ExternalMemory){
+         std::cerr << "ERROR : ''-merge'' can not be used with ''-em''\n";
+         exit(1);
+      }
+      ///only one process merges the segments of an index, the others wait for it
+      FileLock merging(index + ".merge");
+      ///merged segments stay addressable by *idxT* with the highest bit free (see *indexWidthForSize*)
+      const uint64_t max_size = sizeof(idxT) < 8 ? uint64_t(1) << (8 * sizeof(idxT) - 1) : uint64_t(-1);
+      while(true){
+         SegmentManifest manifest(index);
+         uint64_t first, second, id;
+         {
+            FileLock lock(index + ".lock");
+            if(!manifest.read()){
+               std::cerr << "ERROR : ''" << index << "'' does not exist\n";
+               exit(1);
+            }
+            const size_t k = manifest.nextMerge(max_size - 1);
+            if(k == manifest.list().size())
+               return;
+            first = manifest.list()[k].id;
+            second = manifest.list()[k+1].id;
+            id = manifest.reserve();
+            manifest.write();
+         }
+         std::vector<alph> data;
+         if(!read_text(manifest.segmentName(first), data) || !read_text(manifest.segmentName(second), data)){
+            std::cerr << "ERROR : Failed to read the segments " << first << " and " << second << " of ''" << index << "''\n";
+            exit(1);
+         }
+         alph mn, mx;
+         minMax(data.data(), data.data() + data.size(), mn, mx);
+         idxT min = mn;
+         idxT max = mx;
+         dense.clear();
+         if(uint64_t(max) - uint64_t(min) >= DenseAlphabet && uint64_t(max) - uint64_t(min) >= data.size()){
+            denseRanks(data, min, max);
+         }
+         buildWith(modes, modes["Algorithm"], manifest.segmentName(id), data, min, max);
+         if(!appendFingerprints(manifest.segmentName(id), data)){
+            std::cerr << "ERROR : Failed to write the segment ''" << manifest.segmentName(id) << "''\n";
+            exit(1);
+         }
+         {
+            FileLock lock(index + ".lock");
+            manifest.read();
+            manifest.replace(manifest.find(first), id);
+            manifest.write();
+         }
+         std::remove(manifest.segmentName(first).c_str());
+         std::remove(manifest.segmentName(second).c_str());
+      }
+   }
+   
+   ///reads the documents listed in the file *list* and appends *DocumentSeparator* behind every one of them,
+   ///the starts of the documents are stored in *documents*
+   bool read_documents(const std::string& list,
+                       std::vector<alph>& data,
+                       const bool& filt_endline,
+                       const bool& utf8,
+                       idxT& min,
+                       idxT& max){
+      const std::vector<std::string> paths = documentPaths(list);
+      if(paths.empty()){
+         std::cerr << "ERROR : No documents listed in ''" << list << "''\n";
+         return false;
+      }
+      std::vector<idxT> starts;
+      starts.reserve(paths.size());
+      data.reserve(utf8 ? documentsSize(paths) : documentsSize(paths) / sizeof(alph) + paths.size());
+      std::vector<unsigned char> bytes;
+      for(const std::string& path : paths){
+         std::ifstream in(path, std::ios::binary);
+         if(!in.is_open()){
+            std::cerr << "ERROR : Failed to read document ''" << path << "''\n";
+            return false;
+         }
+         bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+         if(!utf8 && bytes.size() % sizeof(alph)){
+            std::cerr << "ERROR : document ''" << path << "'' does not fit into symbols of " << sizeof(alph) << " bytes\n";
+            return false;
+         }
+         starts.push_back(data.size());
+         if(utf8){
+            const unsigned char* p = bytes.data();
+            while(p != bytes.data() + bytes.size()){
+               const alph c = utf8Decode(p, bytes.data() + bytes.size());
+               if(!filt_endline || c != alph('\n'))
+                  data.push_back(c);
+            }
+         }
+         else{
+            const alph* beg = reinterpret_cast<const alph*>(bytes.data());
+            const alph* end = beg + bytes.size() / sizeof(alph);
+            if(filt_endline)
+               std::remove_copy(beg, end, std::back_inserter(data), alph('\n'));
+            else
+               data.insert(data.end(), beg, end);
+         }
+         if(std::find(data.begin() + starts.back(), data.end(), alph(DocumentSeparator)) != data.end()){
+            std::cerr << "ERROR : document ''" << path << "'' contains the separator-symbol " << DocumentSeparator << '\n';
+            return false;
+         }
+         data.push_back(alph(DocumentSeparator));
+      }
+      documents.build(starts, data.size());
+      if(data.size() < 2){
+         std::cerr << "ERROR : data file empty or contains only one character\n";
+         return false;
+      }
+      alph mn, mx;
+      minMax(data.data(), data.data() + data.size(), mn, mx);
+      min = mn;
+      max = mx;
+      return true;
+   }
+   
+   ///''-sp'' samples the suffixes at the starts of words (''space'', ''punct'') or at every k-th index,
+   ///the lcp-array and the other options, that need all suffixes, can not be used with it
+   void checkSparse(const Modes& modes) const {
+      const std::string rule = modes["Sparse"];
+      if(rule != "space" && rule != "punct" && (!is_number(rule) || !std::stoull(rule))){
+         std::cerr << "ERROR : sampling ''" << rule << "'' is not ''space'', ''punct'' or a positive step\n";
+         exit(1);
+      }
+      if(parse_flag(modes["useLCP"]) || parse_flag(modes["TryCompression"]) || parse_flag(modes["Tokens"]) || parse_flag(modes["BWT"])
+         || modes["Chunks"].size() || modes["MemoryBudget"].size() || parse_flag(modes["Checkpoint"]) || parse_flag(modes["Resume"]) 
+         || modes["Algorithm"] != InducedSorting){
+         std::cerr << "ERROR : ''-sp'' can not be used with ''-lcp'', ''-tc'', ''-tok'', ''-bwt'', ''-ch'', "
+                   << "''-mb'', ''-cp'', ''-resume'' or an algorithm\n";
+         exit(1);
+      }
+   }
+   
+   static SparseSampling sparseSampling(const std::string& rule){
+      if(rule == "space")
+         return SparseSampling::Space;
+      if(rule == "punct")
+         return SparseSampling::Punct;
+      return SparseSampling::Step;
+   }
+   
+   ///builds the Burrows-Wheeler-transform of *data* without its suffix-array and writes it to *out_f*:
+   ///header-byte (bit 7 set), count of symbols n, index of the row of suffix 0 (*primary*), 
+   ///the n symbols of the transform without the row of suffix 0
+   void bwt(const std::string& out_f,
+            const std::vector<alph>& data,
+            const idxT& min,
+            const idxT& max) const {
+      checkIndexType<idxT>();
+      checkAlphabetType<alph>();
+      checkDataSizeIdxT<idxT>(data.size());
+      
+      const std::vector<alph>& sort_data = dense.empty() ? data : dense;
+      std::vector<alph> transform;
+      idxT primary;
+      {
+         PhaseTimer t(stats.get(), BuildPhase::Build, 0, data.size());
+         transform = BWTInducedSorting<alph,idxT>(min)(sort_data, max, primary, &data);
+         t.takes(transform);
+      }
+      {
+         PhaseTimer t(stats.get(), BuildPhase::Output, 0, data.size());
+         std::ofstream out(out_f, std::ios::binary);
+         idxT data_size = data.size();
+         unsigned char header = BWTHeaderBit | (alphabetWidthCode<alph>() << 1) | (indexWidthCode<idxT>() << 4);
+         out.write((char*)&header, sizeof(header));
+         out.write((char*)&data_size, sizeof(idxT));
+         out.write((char*)&primary, sizeof(idxT));
+         out.write((char*)transform.data(), sizeof(alph) * primary);
+         out.write((char*)(transform.data() + primary + 1), sizeof(alph) * (data_size - primary));
+         out.close();
+         std::cout << "Data wrote to " << out_f << '\n';
+      }
+      reportStats();
+   }
+   
+   ///finds the phrase *infix* in a stored suffix-array of tokens
+   std::pair<idxT,idxT> findTokensInF(const std::string& infix, 
+                                      const std::string& f_name,
+                                      const std::string& sw) const {
+      std::ifstream in(f_name, std::ios::binary);
+      unsigned char header;
+      idxT data_size;
+      in.read(reinterpret_cast<char*>(&header), sizeof(header));
+      in.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
+      std::vector<alph> data(data_size);
+      in.read(reinterpret_cast<char*>(&data[0]), data_size*sizeof(alph));
+      TokenSuffixArray<alph,idxT> TSA;
+      if(!TSA.read(in)){
+         std::cerr << "ERROR while reading ''" << f_name << "''\n";
+         exit(1);
+      }
+      const std::pair<idxT,idxT> range = TSA.find(infix, data);
+      print_phrase(infix, range, TSA.suffixArray(), data, sw);
+      return range;
+   }
+   
+   void print_phrase(const std::string& infix,
+                     const std::pair<idxT,idxT>& range, 
+                     const std::vector<idxT>& SA, 
+                     const std::vector<alph>& data, 
+                     const std::string& sw) const {
+      std::cout << "Pattern ''";
+      if(range.first == SA.size()){
+         std::cout << infix << "'' Not Found\n";
+      }
+      else{
+         std::cout << infix << "'':\n";
+         print_range(range, SA, data, sw);
+      }
+   }
+   
+   ///symbols with a range of at least this many values are replaced by their ranks for sorting
+   static const uint64_t DenseAlphabet = uint64_t(1) << 22;
+   
+   ///times a search reads the manifest of a segmented index again, if a merge removed one of its segments
+   static const unsigned SegmentRetries = 8;
+   
+   ///fills *dense* with the ranks of the symbols of *data*, *min* and *max* become the smallest and biggest rank
+   void denseRanks(const std::vector<alph>& data, idxT& min, idxT& max){
+      std::vector<alph> symbols(data);
+      std::sort(symbols.begin(), symbols.end());
+      symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+      dense.resize(data.size());
+      tbb::parallel_for(size_t(0), data.size(), [&](const size_t& i){
+         dense[i] = std::lower_bound(symbols.begin(), symbols.end(), data[i]) - symbols.begin();
+      });
+      min = 0;
+      max = symbols.size() - 1;
+   }
+   
+   ///chooses the fastest algorithm, whose estimated peak memory fits into the memory-budget (''-mb''),
+   ///if none fits, the suffix-array is built from disk (''-em''), the memory-cap *cap* is the budget without the mapped input
+   std::string chooseAlgorithm(const Modes& modes, std::string& cap) const {
+      if(!is_number(modes["MemoryBudget"]) || !std::stoull(modes["MemoryBudget"])){
+         std::cerr << "ERROR : memory-budget ''" << modes["MemoryBudget"] << "'' is no positive count of megabytes\n";
+         exit(1);
+      }
+      if(modes["Chunks"].size() || parse_flag(modes["Tokens"])){
+         std::cerr << "ERROR : ''-mb'' can not be used with ''-ch'' or ''-tok''\n";
+         exit(1);
+      }
+      struct stat st;
+      if(stat(modes["InFile"].c_str(), &st)){
+         std::cerr << "ERROR : Failed to read input-corpus-file\n";
+         exit(1);
+      }
+      ///UTF-8 has at most one symbol per byte, wide alphabets are reduced to their ranks, if they are sparse
+      const uint64_t symbols = parse_flag(modes["UTF8"]) ? st.st_size : st.st_size / sizeof(alph);
+      const uint64_t sigma = sizeof(alph) == 1 ? 256 : std::min(uint64_t(1) << (8 * sizeof(alph)), std::max(symbols + 1, uint64_t(DenseAlphabet)));
+      const uint64_t budget = std::stoull(modes["MemoryBudget"]) << 20;
+      MemoryEstimate<alph,idxT> estimate(symbols, sigma, parse_flag(modes["useLCP"]));
+      estimate.report(std::cout);
+      std::string algorithm = estimate.choose(budget);
+      if(algorithm.empty()){
+         if(modes["Infix"].size() || parse_flag(modes["useLCP"]) || parse_flag(modes["UTF8"]) || stats){
+            std::cerr << "ERROR : no algorithm fits into the memory-budget of " << modes["MemoryBudget"] << "MB and ''-em'' "
+                      << "can not be used with ''-f'', ''-lcp'', ''-utf8'' or ''-st''\n";
+            exit(1);
+         }
+         algorithm = ExternalMemory;
+         cap = std::to_string(std::max<uint64_t>(1, (budget - std::min(budget, estimate.external())) >> 20));
+      }
+      std::cout << "Memory-budget " << modes["MemoryBudget"] << "MB: using ''" << algorithm << "''\n";
+      return algorithm;
+   }
+   
+   ///splits the build into chunks, the tag of the chunk-files depends on the input and the build-options,
+   ///so a build with the same arguments reuses the chunks, that are already finished
+   void setChunks(const Modes& modes){
+      if(!is_number(modes["Chunks"]) || !std::stoul(modes["Chunks"])){
+         std::cerr << "ERROR : count of chunks ''" << modes["Chunks"] << "'' is no positive number\n";
+         exit(1);
+      }
+      chunks = std::stoul(modes["Chunks"]);
+      tmp_dir = modes["TempDir"];
+      chunk_tag = buildTag(modes);
+   }
+   
+   ///tag of the temporary files of a build, it depends on the input and the build-options
+   std::string buildTag(const Modes& modes) const {
+      struct stat st;
+      if(stat(modes["InFile"].c_str(), &st)){
+         std::cerr << "ERROR : Failed to read input-corpus-file\n";
+         exit(1);
+      }
+      std::stringstream tag;
+      tag << std::hex << std::hash<std::string>()(modes["InFile"] + '|' + modes["Algorithm"] + '|' 
+                                                  + modes["FilterNewline"] + '|' + modes["Chunks"] + '|'
+                                                  + modes["UTF8"] + '|'
+                                                  + std::to_string(st.st_size) + '|' + std::to_string(st.st_mtime))
+          << '_' << sizeof(alph) << '_' << sizeof(idxT);
+      return tag.str();
+   }
+   
+   ///stores the recursion-levels of ''-is'' in ''-td'', with ''-resume'' the stored levels of the same build are restored
+   void setCheckpoint(const Modes& modes, const std::string& algorithm){
+      if(algorithm != InducedSorting || chunks > 1 || parse_flag(modes["Tokens"])){
+         std::cerr << "ERROR : ''-cp'' and ''-resume'' need ''-is'', they can not be used with ''-ch'' or ''-tok''\n";
+         exit(1);
+      }
+      checkpoint.reset(new BuildCheckpoint(modes["TempDir"], buildTag(modes), parse_flag(modes["Resume"])));
+      ///a new build does not mix its levels with the files of a stopped one
+      if(!checkpoint->resumes())
+         checkpoint->clear();
+   }
+   
+   ///records the phases of the build, the report is written to the file of ''-st'' after *init*
+   void setStats(const Modes& modes){
+      if(modes["Algorithm"] == ExternalMemory || parse_flag(modes["Tokens"])){
+         std::cerr << "ERROR : ''-st'' can not be used with ''-em'' or ''-tok''\n";
+         exit(1);
+      }
+      stats_f = modes["Stats"];
+      stats.reset(new BuildStats());
+   }
+   
+   void reportStats() const {
+      if(!stats)
+         return;
+      std::ofstream out(stats_f);
+      if(!out.is_open()){
+         std::cerr << "ERROR : Failed to open ''" << stats_f << "'' for writing\n";
+         exit(1);
+      }
+      stats->report(out);
+      std::cout << "Build statistics wrote to " << stats_f << '\n';
+   }
+   
+   ///builds the suffix-array of *data* with *algorithm*, then searches the infix or writes it to *out_f*
+   void buildWith(const Modes& modes,
+                  const std::string& algorithm,
+                  const std::string& out_f,
+                  const std::vector<alph>& data,
+                  const idxT& min,
+                  const idxT& max){
+      if(algorithm == Naive){
+         init<SuffixArrayNaive<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayNaive<alph,
+                                idxT>(false),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else if(algorithm == NaiveParallel){
+         init<SuffixArrayNaive<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayNaive<alph,
+                                idxT>(),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else if(algorithm == InducedSortingInPlace){
+         init<SuffixArrayInducedSortingInPlace<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayInducedSortingInPlace<alph,
+                                idxT>(min),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else if(algorithm == InducedSortingParallel){
+         init<SuffixArrayInducedSortingParallel<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayInducedSortingParallel<alph,
+                                idxT>(min),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else if(algorithm == TwoStage){
+         init<SuffixArrayTwoStage<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayTwoStage<alph,
+                                idxT>(min),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else if(algorithm == PrefixDoubling){
+         init<SuffixArrayPrefixDoubling<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayPrefixDoubling<alph,
+                                idxT>(min),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+      }
+      else{
+         init<SuffixArrayInducedSorting<alph,idxT>>
+             (out_f, 
+              modes["Infix"], 
+              SuffixArrayInducedSorting<alph,
+                                idxT>(min, nullptr, stats.get(), checkpoint.get(), parse_flag(modes["ReadAhead"])),
+              parse_flag(modes["useLCP"]),
+              modes["SubstringWidth"],
+              parse_flag(modes["TryCompression"]),
+              data,
+              max);
+         if(checkpoint && checkpoint->resumes())
+            std::cout << "Restored " << checkpoint->restored() << " checkpoint-files\n";
+      }
+   }
+   
    template<typename SAAlg>
    void init(const std::string out_f,
             const std::string& infix,
@@ -148,34 +966,73 @@ private:
       checkAlphabetType<alph>();
       checkDataSizeIdxT<idxT>(data.size());
       
-      std::vector<idxT> SA = SuffixArrayAlgorithm(data, max);
+      const std::vector<alph>& sort_data = dense.empty() ? data : dense;
+      std::vector<idxT> SA;
+      ///lcp-array, if the algorithm induces it together with the suffix-array
+      std::vector<idxT> lcp_arr;
+      {
+         PhaseTimer t(stats.get(), BuildPhase::Build, 0, data.size());
+         SA = chunks > 1 ? SuffixArrayChunked<alph,idxT,SAAlg>(SuffixArrayAlgorithm, 
+                                                               chunks, 
+                                                               tmp_dir, 
+                                                               chunk_tag)(sort_data, max)
+                         : build(SuffixArrayAlgorithm, sort_data, max, lcp ? &lcp_arr : nullptr);
+         t.takes(SA);
+      }
       
       std::vector<std::vector<idxT>> lcp_l;
       std::vector<std::vector<idxT>> lcp_r;
       
       if(lcp){
-         LCP<alph,idxT> lcpAlg;
+         PhaseTimer t(stats.get(), BuildPhase::LCP, 0, SA.size());
+         if(lcp_arr.empty()){
+            LCP<alph,idxT> lcpAlg;
+            lcp_arr = lcpAlg(data, SA);
+         }
          
-         NaiveLCP_LR<alph,idxT>(SA, lcpAlg(data, SA), lcp_l, lcp_r);
+         NaiveLCP_LR<alph,idxT>(SA, lcp_arr, lcp_l, lcp_r);
+         for(idxT i = 0 ; i < lcp_l.size() ; ++i){
+            t.takes(lcp_l[i]);
+            t.takes(lcp_r[i]);
+         }
       }
       
-      if(infix.size()){
-         std::pair<idxT,idxT> range = find_all_infix(infix, data, SA, lcp_l, lcp_r);
-         
-         std::cout << "Pattern ''";
-         if(range.first == SA.size()){
-            std::cout << infix << "'' Not Found\n";
+      {
+         PhaseTimer t(stats.get(), BuildPhase::Output, 0, SA.size());
+         if(infix.size()){
+            std::pair<idxT,idxT> range = find_all_infix(infix, data, SA, lcp_l, lcp_r);
+            
+            std::cout << "Pattern ''";
+            if(range.first == SA.size()){
+               std::cout << infix << "'' Not Found\n";
+            }
+            else{
+               std::cout << infix << "'':\n";
+               print_range(range, SA, data, sw, documents.count() ? &documents : nullptr);
+            }
          }
          else{
-            std::cout << infix << "'':\n";
-            print_range(range, SA, data, sw);
+            write(data, SA, out_f, lcp_l, lcp_r, cmpr);
+            std::cout << "Data wrote to " << out_f << '\n';
          }
       }
-      else{
-         write(data, SA, out_f, lcp_l, lcp_r, cmpr);
-         std::cout << "Data wrote to " << out_f << '\n';
-      }
-      
+      reportStats();
+   }
+   
+   ///builds the suffix-array with *SuffixArrayAlgorithm*, only *-is* sets the lcp-array *lcp_arr* too
+   template<typename SAAlg>
+   static std::vector<idxT> build(SAAlg& SuffixArrayAlgorithm,
+                                  const std::vector<alph>& data,
+                                  const idxT& max,
+                                  std::vector<idxT>*){
+      return SuffixArrayAlgorithm(data, max);
+   }
+   
+   static std::vector<idxT> build(SuffixArrayInducedSorting<alph,idxT>& SuffixArrayAlgorithm,
+                                  const std::vector<alph>& data,
+                                  const idxT& max,
+                                  std::vector<idxT>* lcp_arr){
+      return SuffixArrayAlgorithm(data, max, lcp_arr);
    }
    
    std::pair<idxT,idxT> find_all_infix(const std::string& infix_in, 
@@ -184,10 +1041,7 @@ private:
                                        const std::vector<std::vector<idxT>>& lcp_l,
                                        const std::vector<std::vector<idxT>>& lcp_r) const {
 //       auto start(std::chrono::steady_clock::now());
-      std::vector<alph> infix;
-      infix.reserve(infix_in.size());
-      for(alph e : infix_in)
-         infix.push_back(e);
+      const std::vector<alph> infix = patternSymbols(infix_in);
       
       if(lcp_l.size()){
          std::pair<idxT,idxT> range = lower_bound(data, SA, lcp_l, lcp_r, infix);
@@ -230,6 +1084,20 @@ private:
       }
    }
    
+   ///symbols of the pattern *infix_in*, wide symbols are searched by the code-points of the UTF-8-pattern
+   static std::vector<alph> patternSymbols(const std::string& infix_in){
+      std::vector<alph> infix;
+      if(sizeof(alph) > 1){
+         infix = utf8DecodeString<alph>(infix_in);
+      }
+      else{
+         infix.reserve(infix_in.size());
+         for(alph e : infix_in)
+            infix.push_back(e);
+      }
+      return infix;
+   }
+   
    bool is_number(const std::string& s) const {
       auto it = s.begin();
       while(it != s.end() && std::isdigit(*it)) 
@@ -251,54 +1119,134 @@ private:
       return true;
    }
    
+   ///smallest and biggest character of [beg, end)
+   template<typename T>
+   static void minMax(const T* beg, const T* end, T& mn, T& mx){
+      mn = std::numeric_limits<T>::max();
+      mx = std::numeric_limits<T>::lowest();
+      for( ; beg != end ; ++beg){
+         mn = std::min(mn, *beg);
+         mx = std::max(mx, *beg);
+      }
+   }
+   
+#ifdef __SSE2__
+   ///unsigned bytes are reduced 16 at a time
+   static void minMax(const unsigned char* beg, const unsigned char* end, unsigned char& mn, unsigned char& mx){
+      __m128i vmn = _mm_set1_epi8(char(0xFF)), vmx = _mm_setzero_si128();
+      for( ; end - beg >= 16 ; beg += 16){
+         const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(beg));
+         vmn = _mm_min_epu8(vmn, v);
+         vmx = _mm_max_epu8(vmx, v);
+      }
+      alignas(16) unsigned char lo[16], hi[16];
+      _mm_store_si128(reinterpret_cast<__m128i*>(lo), vmn);
+      _mm_store_si128(reinterpret_cast<__m128i*>(hi), vmx);
+      minMax<unsigned char>(beg, end, mn, mx);
+      mn = std::min(mn, *std::min_element(lo, lo + 16));
+      mx = std::max(mx, *std::max_element(hi, hi + 16));
+   }
+#endif
+   
+   ///next newline-symbol in [beg, end), *end* if there is none
+   static const alph* nextNewline(const alph* beg, const alph* end){
+      if(sizeof(alph) == 1){
+         const void* nl = memchr(beg, '\n', end - beg);
+         return nl ? static_cast<const alph*>(nl) : end;
+      }
+      return std::find(beg, end, alph('\n'));
+   }
+   
+   ///bytes of the input-corpus, that are loaded by one task
+   static const size_t LoadBlock = 1 << 20;
+   
+   ///reads the input-corpus by memory-mapping it, *data* is filled in blocks of *LoadBlock* bytes in parallel,
+   ///every block copies its symbols (without newlines, if *filt_endline* is set) and reduces their min and max
+   ///- the file holds symbols of *sizeof(alph)* bytes (little-endian) or UTF-8, that is decoded to code-points (*utf8*)
    bool read_data(const std::string& f_name,
                   std::vector<alph>& data,
                   const bool& filt_endline,
+                  const bool& utf8,
                   idxT& min,
                   idxT& max) const {
-      ///IF *filt_endline* IS SET TO TRUE && *alph* SET TO A DATA-TYPE,THAT IS SMALLER THAN UNSIGNED && LCP IS USED, THERE IS A SEGMENTATION FAULT WITH MY TEST-CORPUS!!
-      
-      std::ifstream stream(f_name);
-      if(!stream.is_open()){
+      if(access(f_name.c_str(), R_OK)){
          std::cerr << "ERROR : Failed to read data\n";
          return false;
       }
-//       if(filt_endline){
-//          std::string buf;
-//          while(std::getline(stream, buf)){
-//             data.reserve(buf.size());
-//             for(auto i = buf.begin() ; i != buf.end() ; ++i){
-//                data.push_back(*i);
-//             }
-//          }
-//       }
-//       else{
-      if(filt_endline){
-         for(std::istreambuf_iterator<char> i(stream), e ; i != e ; ++i){
-            if((*i) != '\n'){
-               
-               if((alph)(*i) < min)
-                  min = (alph)(idxT)(*i);
-               if((alph)(*i) > max)
-                  max = (alph)(idxT)(*i);
-               
-               data.push_back(*i);
+      MappedFile<unsigned char> in(f_name);
+      in.advise(true);
+      const unsigned char* text = in.data();
+      const size_t bytes = in.size();
+      if(utf8 ? (sizeof(alph) < 4 && utf8SymbolWidth(text, text + bytes) > sizeof(alph)) : bytes % sizeof(alph)){
+         std::cerr << "ERROR : input-corpus does not fit into symbols of " << sizeof(alph) << " bytes\n";
+         return false;
+      }
+      ///1. bounds of the blocks, a UTF-8-block starts with the first byte of a symbol
+      const size_t blocks = (bytes + LoadBlock - 1) / LoadBlock;
+      std::vector<size_t> bounds(blocks + 1, bytes);
+      for(size_t b = 0 ; b < blocks ; ++b){
+         bounds[b] = b * LoadBlock;
+         while(utf8 && b && bounds[b] < bytes && utf8Continuation(text[bounds[b]]))
+            ++bounds[b];
+      }
+      ///2. offset of every block in *data*, blocks shrink by their newlines
+      std::vector<size_t> offsets(blocks + 1, 0);
+      tbb::parallel_for(size_t(0), blocks, [&](const size_t& b){
+         if(utf8){
+            size_t k = 0;
+            for(size_t i = bounds[b] ; i < bounds[b + 1] ; ++i){
+               k += !utf8Continuation(text[i]) && !(filt_endline && text[i] == '\n');
             }
+            offsets[b + 1] = k;
+            return;
+         }
+         const alph* beg = reinterpret_cast<const alph*>(text + bounds[b]);
+         const alph* end = reinterpret_cast<const alph*>(text + bounds[b + 1]);
+         offsets[b + 1] = end - beg;
+         if(filt_endline){
+            for(const alph* nl = beg ; (nl = nextNewline(nl, end)) != end ; ++nl)
+               --offsets[b + 1];
          }
+      });
+      for(size_t b = 0 ; b < blocks ; ++b){
+         offsets[b + 1] += offsets[b];
       }
-      else{
-         for(std::istreambuf_iterator<char> i(stream), e ; i != e ; ++i){
-            if((alph)(*i) < min)
-               min = (alph)(*i);
-            if((alph)(*i) > max)
-               max = (alph)(*i);
-            
-            data.push_back(*i);
+      data.resize(offsets[blocks]);
+      ///3. copy or decode the blocks and reduce min and max of every block
+      std::vector<alph> mins(blocks), maxs(blocks);
+      tbb::parallel_for(size_t(0), blocks, [&](const size_t& b){
+         alph* out = data.data() + offsets[b];
+         if(utf8){
+            const unsigned char* p = text + bounds[b];
+            const unsigned char* end = text + bounds[b + 1];
+            while(p != end && utf8Continuation(*p))
+               ++p;
+            while(p != end){
+               const uint32_t cp = utf8Decode(p, end);
+               if(!filt_endline || cp != '\n')
+                  *out++ = cp;
+            }
          }
+         else{
+            const alph* beg = reinterpret_cast<const alph*>(text + bounds[b]);
+            const alph* end = reinterpret_cast<const alph*>(text + bounds[b + 1]);
+            if(filt_endline){
+               for(const alph* nl ; (nl = nextNewline(beg, end)) != end ; beg = nl + 1){
+                  out = std::copy(beg, nl, out);
+               }
+            }
+            std::copy(beg, end, out);
+         }
+         minMax(data.data() + offsets[b], data.data() + offsets[b + 1], mins[b], maxs[b]);
+      });
+      for(size_t b = 0 ; b < blocks ; ++b){
+         if(offsets[b] == offsets[b + 1])
+            continue;
+         if(mins[b] < min)
+            min = mins[b];
+         if(maxs[b] > max)
+            max = maxs[b];
       }
-//       }
-      data.shrink_to_fit();
-      stream.close();
       
       if(!data.size()){
          std::cerr << "ERROR : No data in file\n";
@@ -333,8 +1281,8 @@ private:
       
       struct CompLess{
       public:
-         bool operator()(const alph& cSizet, const char& c) const {
-            return cSizet < (alph)c;
+         bool operator()(const alph& a, const alph& b) const {
+            return a < b;
          }
       private:
       };
@@ -361,11 +1309,24 @@ private:
              std::vector<idxT>& SA,
              std::vector<std::vector<idxT>>& lcp_l,
              std::vector<std::vector<idxT>>& lcp_r,
-             const std::string& f_name) const {
+             const std::string& f_name,
+             DocumentBoundaries<idxT>* docs=nullptr) const {
       std::ifstream strm_in(f_name, std::ios::binary);
       if(strm_in.is_open()){
-         bool cmpr;
-         strm_in.read(reinterpret_cast<char*>(&cmpr), sizeof(cmpr));
+         ///header-byte: bit 0 compression, bits 1-2 symbol-width, bit 3 sparse, bits 4-5 index-width
+         unsigned char header;
+         strm_in.read(reinterpret_cast<char*>(&header), sizeof(header));
+         if(indexWidthFromCode(header) != sizeof(idxT)){
+            std::cerr << "ERROR : ''" << f_name << "'' was stored with " 
+                      << indexWidthFromCode(header) << "-byte indices\n";
+            exit(1);
+         }
+         if(alphabetWidthFromCode(header) != sizeof(alph)){
+            std::cerr << "ERROR : ''" << f_name << "'' was stored with " 
+                      << alphabetWidthFromCode(header) << "-byte symbols\n";
+            exit(1);
+         }
+         bool cmpr = header & 1;
          
          idxT data_size;
          strm_in.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
@@ -374,6 +1335,11 @@ private:
          
          strm_in.read(reinterpret_cast<char*>(&data[0]), data_size*sizeof(alph));
          
+         ///a sparse suffix-array stores the count of its suffixes
+         idxT sa_size = data_size;
+         if(header & SparseHeaderBit)
+            strm_in.read(reinterpret_cast<char*>(&sa_size), sizeof(sa_size));
+         ++sa_size;
          ++data_size;
          idxT max_idx_size;
          if(cmpr){
@@ -387,8 +1353,8 @@ private:
 //             SA.shrink_to_fit();
          }
          else{
-            SA.resize(data_size, idxT());
-            strm_in.read(reinterpret_cast<char*>(&SA[0]), (data_size) * sizeof(idxT));
+            SA.resize(sa_size, idxT());
+            strm_in.read(reinterpret_cast<char*>(&SA[0]), (sa_size) * sizeof(idxT));
          }
          read_lcp_lr(strm_in,
                     lcp_l,
@@ -396,11 +1362,26 @@ private:
                     cmpr,
                     data_size,
                     max_idx_size);
+         ///the starts of the documents of ''-docs'' follow the suffix-array
+         if(docs && strm_in.peek() != EOF)
+            docs->read(strm_in);
          
          return true;
       }
       return false;
    }
+   ///appends the input, that is stored in front of the suffix-array in *f_name*, to *data*
+   bool read_text(const std::string& f_name, std::vector<alph>& data) const {
+      std::ifstream strm_in(f_name, std::ios::binary);
+      unsigned char header;
+      idxT data_size;
+      if(!strm_in.read(reinterpret_cast<char*>(&header), sizeof(header)) 
+         || !strm_in.read(reinterpret_cast<char*>(&data_size), sizeof(data_size)))
+         return false;
+      const size_t k = data.size();
+      data.resize(k + data_size);
+      return bool(strm_in.read(reinterpret_cast<char*>(&data[k]), data_size * sizeof(alph)));
+   }
    ///function read lcp-lr-array
    void read_lcp_lr(std::istream& strm_in,
                     std::vector<std::vector<idxT>>& lcp_l,
@@ -464,12 +1445,22 @@ private:
       std::ofstream out(f_name, std::ios::binary);
       idxT data_size = data.size();
       
-      out.write((char*)&cmpr, sizeof(bool));
+      ///a suffix-array of ''-sp'' holds less suffixes than the input
+      const bool sparse = uint64_t(SA.size()) != uint64_t(data_size) + 1;
+      
+      ///header-byte: bit 0 compression, bits 1-2 symbol-width, bit 3 sparse, bits 4-5 index-width
+      unsigned char header = (cmpr ? 1 : 0) | (alphabetWidthCode<alph>() << 1) | (sparse ? SparseHeaderBit : 0) | (indexWidthCode<idxT>() << 4);
+      out.write((char*)&header, sizeof(header));
       
       out.write((char*)&data_size, sizeof(idxT));
       
       out.write((char*)(&(*(data.begin()))), sizeof(alph) * data_size);
       
+      if(sparse){
+         idxT sa_size = SA.size() - 1;
+         out.write((char*)&sa_size, sizeof(idxT));
+      }
+      
       if(cmpr){
          writeCompSA(out,
                      SA, 
@@ -480,10 +1471,12 @@ private:
       else{
          bin_writeSA(out,
                      &(*(SA.begin())), 
-                     data_size,
+                     SA.size() - 1,
                      lcp_l,
                      lcp_r);
       }
+      if(documents.count())
+         documents.write(out);
       out.close();
    }
    
@@ -554,25 +1547,45 @@ private:
    
    void print_range(const std::pair<idxT,idxT>& range, 
                     const std::vector<idxT>& SA, 
-                    const std::vector<alph> data, 
-                    const std::string& sw) const {
+                    const std::vector<alph>& data, 
+                    const std::string& sw,
+                    const DocumentBoundaries<idxT>* docs=nullptr) const {
+      print_matches(uint64_t(range.first), uint64_t(range.second), SA.data() + range.first, data, sw, docs);
+   }
+   
+   ///prints the ranks [first, last) and the positions *pos* of their suffixes in *data*,
+   ///*textT* is a vector or a *SegmentView* of the text
+   template<typename posT, typename textT>
+   void print_matches(const uint64_t& first,
+                      const uint64_t& last,
+                      const posT* pos,
+                      const textT& data, 
+                      const std::string& sw,
+                      const DocumentBoundaries<idxT>* docs=nullptr) const {
       std::cout << "Suffix-array-indices-range :\n\t("
-                  << range.first << ", " <<range.second << ")\nString-indices:\n";
+                  << first << ", " << last << ")\nString-indices:\n";
       
       unsigned subwidth = 0;
       if(is_number(sw)){
          subwidth = std::stoul(sw);
       }
-      for(idxT i = range.first ; i < range.second ; ++i){
-         std::cout << '\t' << SA[i];
+      for(uint64_t i = 0 ; i < last - first ; ++i){
+         const uint64_t p = pos[i];
+         std::cout << '\t' << p;
+         if(docs){
+            const std::pair<idxT,idxT> loc = docs->locate(p);
+            std::cout << "\t(document " << loc.first << ", offset " << loc.second << ')';
+         }
          if(subwidth){
             std::cout << " :\t";
 //             unsigned s = subwidth;
-            for(unsigned j = 0 ; j < subwidth && SA[i]+j < data.size() ; ++j){
-               if(data[SA[i]+j] == '\n')
+            for(unsigned j = 0 ; j < subwidth && p+j < data.size() && !(docs && data[p+j] == alph(DocumentSeparator)) ; ++j){
+               if(data[p+j] == '\n')
                   std::cout << "\\n";
+               else if(sizeof(alph) > 1)
+                  utf8Encode(std::cout, data[p+j]);
                else
-                  std::cout << (char)data[SA[i]+j];
+                  std::cout << (char)data[p+j];
             }
             std::cout << '\n';
          }
@@ -581,6 +1594,19 @@ private:
       }
    }
    
+   ///ranks of the symbols, if the alphabet is too sparse for the buckets of the engines
+   std::vector<alph> dense;
+   ///count of chunks, that are built by worker-processes (1: no chunks), see *SuffixArrayChunked*
+   unsigned chunks = 1;
+   std::string tmp_dir;
+   std::string chunk_tag;
+   ///phases of the build, only recorded with ''-st''
+   std::unique_ptr<BuildStats> stats;
+   std::string stats_f;
+   ///recursion-levels of ''-is'', only stored with ''-cp'' or ''-resume''
+   std::unique_ptr<BuildCheckpoint> checkpoint;
+   ///starts of the documents of ''-docs''
+   DocumentBoundaries<idxT> documents;
 };
 
 
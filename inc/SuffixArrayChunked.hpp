@@ -0,0 +1,255 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include "typeChecks.hpp"
+#include "DifferenceCover.hpp"
+
+///Template-Function-Object for creating a suffix-array in chunks, that are built by worker-processes and merged afterwards
+template<typename alph, typename idxT, typename SAAlg>
+class SuffixArrayChunked{
+   ///- typename *SAAlg*
+   ///> engine, that builds the suffix-array of every chunk (e.g. *SuffixArrayInducedSorting* or *SuffixArrayNaive*)
+   ///
+   ///The input is split into *chunks* parts, every part is sorted by its own forked process.
+   ///Before the workers are forked, the parent ranks a difference-cover sample of the whole input (*DifferenceCoverSample*),
+   ///the workers share it, so any two suffixes are ordered by at most 256 characters and two ranks.
+   ///A worker builds the suffix-array of its chunk followed by the next *Overlap* characters,
+   ///so two suffixes of the chunk are ordered like in the whole input, if they differ within *Overlap* characters.
+   ///Runs of suffixes, that are equal for *Overlap* characters, are repaired with the ranks of the sample.
+   ///
+   ///The workers only share the files *tmp_dir*/SA_chunk_*tag*_*i*.tmp with the parent process.
+   ///A chunk-file is renamed to its final name, when it is complete, so a chunk, that already has its file
+   ///(e.g. from a build, that was stopped), is not built again. A failed worker is restarted once.
+   ///The parent merges the sorted chunks by comparing their suffixes with the sample.
+public:
+   ///constructor sets the engine of the chunks, the count of chunks, the directory of the chunk-files
+   ///and a tag, that identifies the build
+   SuffixArrayChunked(const SAAlg& engine,
+                      const unsigned& chunks,
+                      const std::string& tmp_dir,
+                      const std::string& tag)
+   : alg(engine), k(chunks), dir(tmp_dir), id(tag)
+   {}
+
+   ///- *operator()*, takes a *std::vector* of type *alph* as argument
+   ///- returns a *std::vector* of type *idxT* (final suffix-array)
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max) const {
+      checkIndexType<idxT>();
+      checkDataSizeIdxT<idxT>(alph_cont.size());
+
+      const idxT n = alph_cont.size();
+      ///every chunk holds at least two characters
+      const idxT count = std::max<idxT>(1, std::min<idxT>(k, n >> 1));
+      std::vector<idxT> bounds(count + 1);
+      for(idxT i = 0 ; i <= count ; ++i){
+         bounds[i] = uint64_t(n) * i / count;
+      }
+      const DifferenceCoverSample<alph,idxT> sample(alph_cont);
+      ///1. build the missing chunks, every worker at most twice
+      for(unsigned attempt = 0 ; attempt < 2 ; ++attempt){
+         std::vector<std::pair<pid_t, idxT>> workers;
+         for(idxT i = 0 ; i < count ; ++i){
+            if(complete(i, bounds[i+1] - bounds[i]))
+               continue;
+            const pid_t pid = fork();
+            if(pid < 0){
+               std::cerr << "ERROR : Failed to start a worker for chunk " << i << '\n';
+               exit(1);
+            }
+            if(!pid){
+               _exit(buildChunk(alph_cont, sample, max, bounds[i], bounds[i+1], i) ? 0 : 1);
+            }
+            workers.push_back(std::make_pair(pid, i));
+         }
+         for(const auto& w : workers){
+            int status;
+            waitpid(w.first, &status, 0);
+            if(!WIFEXITED(status) || WEXITSTATUS(status)){
+               std::cerr << "WARNING : worker of chunk " << w.second << " failed\n";
+            }
+         }
+      }
+      for(idxT i = 0 ; i < count ; ++i){
+         if(!complete(i, bounds[i+1] - bounds[i])){
+            std::cerr << "ERROR : chunk " << i << " could not be built, finished chunks are kept in ''" << dir << "''\n";
+            exit(1);
+         }
+      }
+      ///2. merge the chunks
+      std::vector<idxT> SA = merge(alph_cont, sample, count);
+      for(idxT i = 0 ; i < count ; ++i){
+         std::remove(chunkName(i).c_str());
+      }
+      return SA;
+   }
+
+private:
+   ///characters behind a chunk, that are sorted with it
+   static const size_t Overlap = 64;
+   ///suffixes, that are read from a chunk-file at once
+   static const size_t ReadBlock = 1 << 16;
+
+   std::string chunkName(const idxT& i) const {
+      std::stringstream buf;
+      buf << dir << "/SA_chunk_" << id << '_' << i << ".tmp";
+      return buf.str();
+   }
+
+   ///checks if the file of chunk i exists and holds *len* indices
+   bool complete(const idxT& i, const idxT& len) const {
+      struct stat st;
+      return !stat(chunkName(i).c_str(), &st) && uint64_t(st.st_size) == uint64_t(len) * sizeof(idxT);
+   }
+
+   ///runs in the worker process: sorts the suffixes [b, e) and writes them to the chunk-file
+   bool buildChunk(const std::vector<alph>& alph_cont,
+                   const DifferenceCoverSample<alph,idxT>& sample,
+                   const idxT& max,
+                   const idxT& b,
+                   const idxT& e,
+                   const idxT& i) const {
+      const idxT n = alph_cont.size();
+      const idxT E = std::min<uint64_t>(n, uint64_t(e) + Overlap);
+      const std::vector<alph> part(alph_cont.begin() + b, alph_cont.begin() + E);
+      SAAlg engine(alg);
+      const std::vector<idxT> local = engine(part, max);
+
+      std::vector<idxT> SA;
+      SA.reserve(e - b);
+      for(idxT j = 1 ; j < local.size() ; ++j){
+         if(local[j] < e - b)
+            SA.push_back(local[j] + b);
+      }
+      ///suffixes, that are equal for *Overlap* characters, may be cut by the end of the part
+      if(E < n)
+         repair(alph_cont, sample, SA);
+
+      const std::string f_name = chunkName(i);
+      const std::string part_name = f_name + ".part";
+      std::ofstream out(part_name, std::ios::binary);
+      out.write((const char*)&SA[0], sizeof(idxT) * SA.size());
+      out.close();
+      return out && !std::rename(part_name.c_str(), f_name.c_str());
+   }
+
+   ///sorts the runs of neighbouring suffixes, that share their first *Overlap* characters, by the sample
+   void repair(const std::vector<alph>& alph_cont, 
+               const DifferenceCoverSample<alph,idxT>& sample, 
+               std::vector<idxT>& SA) const {
+      const alph* T = &alph_cont[0];
+      for(idxT r = 0 ; r < SA.size() ; ){
+         idxT s = r;
+         while(s + 1 < SA.size() && std::equal(T + SA[s], T + SA[s] + Overlap, T + SA[s+1]))
+            ++s;
+         if(s > r)
+            repairRun(sample, &SA[r], s - r + 1);
+         r = s + 1;
+      }
+   }
+
+   ///the engine took a suffix, that reached the end of the part, as smaller, so it can only stand too early in its run.
+   ///A stack keeps the suffixes, that are in order, the others are moved aside, sorted and merged back.
+   void repairRun(const DifferenceCoverSample<alph,idxT>& sample, idxT* run, const size_t& len) const {
+      auto less = [&](const idxT& a, const idxT& b){
+         return sample.less(a, b);
+      };
+      std::vector<idxT> moved;
+      size_t top = 0;
+      for(size_t i = 0 ; i < len ; ++i){
+         const idxT x = run[i];
+         while(top && less(x, run[top - 1]))
+            moved.push_back(run[--top]);
+         run[top++] = x;
+      }
+      if(moved.empty())
+         return;
+      std::sort(moved.begin(), moved.end(), less);
+      std::vector<idxT> kept(run, run + top);
+      std::merge(kept.begin(), kept.end(), moved.begin(), moved.end(), run, less);
+   }
+
+   ///reads the suffixes of a chunk-file in blocks
+   struct ChunkReader{
+      std::ifstream in;
+      std::vector<idxT> buf;
+      size_t at = 0;
+
+      ///reads the next suffix into *pos*, false at the end of the file
+      bool next(idxT& pos){
+         if(at == buf.size()){
+            buf.resize(ReadBlock);
+            in.read((char*)&buf[0], sizeof(idxT) * ReadBlock);
+            buf.resize(in.gcount() / sizeof(idxT));
+            at = 0;
+            if(buf.empty())
+               return false;
+         }
+         pos = buf[at++];
+         return true;
+      }
+   };
+
+   ///merges the sorted chunks by a tournament-tree of the current suffix of every chunk,
+   ///every inner node holds the loser of its match, so every suffix takes log2(*count*) comparisons
+   std::vector<idxT> merge(const std::vector<alph>& alph_cont, 
+                           const DifferenceCoverSample<alph,idxT>& sample, 
+                           const idxT& count) const {
+      size_t leaves = 1;
+      while(leaves < count)
+         leaves <<= 1;
+      std::vector<ChunkReader> files(count);
+      std::vector<idxT> current(leaves);
+      std::vector<char> alive(leaves, 0);
+      for(idxT i = 0 ; i < count ; ++i){
+         files[i].in.open(chunkName(i), std::ios::binary);
+         alive[i] = files[i].next(current[i]);
+      }
+      ///checks if the chunk *x* wins against the chunk *y*
+      auto wins = [&](const size_t& x, const size_t& y){
+         return alive[x] && (!alive[y] || sample.less(current[x], current[y]));
+      };
+      ///tree[1, leaves) holds the losers, the winners of the matches are found bottom up
+      std::vector<size_t> tree(leaves), winner(2 * leaves);
+      for(size_t j = 0 ; j < leaves ; ++j)
+         winner[leaves + j] = j;
+      for(size_t v = leaves ; v-- > 1 ; ){
+         const size_t x = winner[2 * v], y = winner[2 * v + 1];
+         winner[v] = wins(y, x) ? y : x;
+         tree[v] = winner[v] == x ? y : x;
+      }
+      size_t top = winner[1];
+      std::vector<size_t>().swap(winner);
+      std::vector<idxT> SA;
+      SA.reserve(alph_cont.size() + 1);
+      SA.push_back(alph_cont.size());
+      while(alive[top]){
+         SA.push_back(current[top]);
+         alive[top] = files[top].next(current[top]);
+         for(size_t v = (leaves + top) >> 1 ; v ; v >>= 1){
+            if(wins(tree[v], top))
+               std::swap(tree[v], top);
+         }
+      }
+      if(SA.size() != alph_cont.size() + 1){
+         std::cerr << "ERROR : chunk-files in ''" << dir << "'' are incomplete\n";
+         exit(1);
+      }
+      return SA;
+   }
+
+   const SAAlg alg;
+   const unsigned k;
+   const std::string dir;
+   const std::string id;
+};
@@ -0,0 +1,490 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <memory>
+#include <type_traits>
+#include <cstdio>
+#include <unistd.h>
+#include "typeChecks.hpp"
+#include "IndexTypes.hpp"
+#include "MappedFile.hpp"
+#include "tbb/parallel_sort.h"
+
+///Function-Object for creating a suffix-array of a corpus, that does not fit into the main memory together with its suffix-array
+template<typename alph=char, typename idxT=size_t>
+class SuffixArrayExternal{
+   ///- typename *alph*
+   ///> type of elements of the input-file
+   ///
+   ///- typename idxT
+   ///> determines type of indices, stored in the final suffix-array
+   ///
+   ///This is prefix-doubling on files (U. Manber and G. Myers, with the ranks of N.J. Larsson and K. Sadakane):
+   ///the rank of a suffix is 1 + the count of suffixes with a smaller prefix of h characters, it is stored in the file
+   ///of ranks in the order of the text, suffixes, whose group is not sorted yet, are marked by the highest bit.
+   ///Every round writes the group, the rank h positions further and the position of every marked suffix
+   ///(two sequential scans of the ranks), sorts these records and writes the new ranks, then h is doubled.
+   ///So there are at most log(n) rounds, no matter how repetitive the input is, and sorted suffixes drop out.
+   ///The first round sorts all suffixes by their first characters, packed into one number.
+   ///
+   ///The input is memory-mapped and only read sequentially. Files of records are sorted in runs of the memory-cap,
+   ///that are merged afterwards (up to *MaxOpenRuns* at once), every other file is read and written in blocks
+   ///of *StreamBlock* records, so the memory of the build is the memory-cap and the blocks of the open files.
+   ///All temporary files are stored under *tmp_dir*.
+public:
+   ///constructor sets the directory of the temporary files, the memory-cap in bytes and if the runs are sorted in parallel
+   SuffixArrayExternal(const std::string& tmp_dir,
+                       const size_t& mem_cap,
+                       const bool& p=true)
+   : dir(tmp_dir), cap(mem_cap), p_mode(p)
+   {}
+
+   ///builds the suffix-array of the file *in_f* and writes it to *out_f* in the format of *SuffixArray::write* (without lcp-lr)
+   void operator()(const std::string& in_f,
+                   const bool& filt_endline,
+                   const std::string& out_f,
+                   const bool& cmpr) const {
+      checkIndexType<idxT>();
+      checkAlphabetType<alph>();
+      if(cap < 4 * StreamBlock * sizeof(Triple)){
+         std::cerr << "ERROR : The memory-cap of ''-em'' holds less than " << 4 * StreamBlock << " records of the sorting\n";
+         exit(1);
+      }
+      ///1. with filtered newlines the text is copied to a temporary file first, so it can be mapped
+      const std::string text_f = filt_endline ? tmpName("text") : in_f;
+      if(filt_endline)
+         filterNewlines(in_f, text_f);
+      {
+         MappedFile<alph> text(text_f);
+         const idxT n = text.size();
+         if(!n){
+            std::cerr << "ERROR : No data in file\n";
+            exit(1);
+         }
+         if(n < 2){
+            std::cerr << "ERROR : data file empty or contains only one character\n";
+            exit(1);
+         }
+         checkDataSizeIdxT<idxT>(text.size());
+         if(uint64_t(n) >= uint64_t(Mark)){
+            std::cerr << "ERROR : Input has too many positions for index-type(idxT) of ''-em''!!!\n";
+            exit(1);
+         }
+         text.advise(true);
+         const alph* T = text.data();
+
+         ///2. write the header, the text and the empty suffix
+         std::ofstream out(out_f, std::ios::binary);
+         if(!out.is_open()){
+            std::cerr << "ERROR : Failed to open ''" << out_f << "'' for writing\n";
+            exit(1);
+         }
+         unsigned char header = (cmpr ? 1 : 0) | (alphabetWidthCode<alph>() << 1) | (indexWidthCode<idxT>() << 4);
+         out.write((char*)&header, sizeof(header));
+         out.write((char*)&n, sizeof(idxT));
+         out.write((const char*)T, sizeof(alph) * n);
+         idxT max_idx_size = 0;
+         if(cmpr){
+            std::stringstream buf;
+            buf << std::hex << n;
+            max_idx_size = buf.str().size();
+            out.write((char*)&max_idx_size, sizeof(idxT));
+         }
+         writeEntries(out, &n, 1, cmpr, max_idx_size);
+
+         ///3. sort the suffixes by prefix-doubling and append them
+         const std::string ranks_f = tmpName("ranks");
+         const uint64_t h = firstRound(T, n, ranks_f);
+         doubling(n, h, ranks_f);
+         writeSuffixes(n, ranks_f, out, cmpr, max_idx_size);
+
+         bool use_lcp = false;
+         out.write((char*)&use_lcp, sizeof(bool));
+         out.close();
+         if(!out){
+            std::cerr << "ERROR : Failed to write ''" << out_f << "''\n";
+            exit(1);
+         }
+      }
+      if(filt_endline)
+         std::remove(text_f.c_str());
+   }
+
+private:
+   typedef typename std::make_unsigned<alph>::type ualph;
+
+   ///the suffix *pos* of the group *group* (its rank), that is refined by *key*
+   struct Triple{
+      idxT group;
+      idxT key;
+      idxT pos;
+
+      bool operator<(const Triple& o) const {
+         return group != o.group ? group < o.group : (key != o.key ? key < o.key : pos < o.pos);
+      }
+   };
+
+   ///the suffix *pos* and its rank *rank*, ordered by the suffix
+   struct Rank{
+      idxT pos;
+      idxT rank;
+
+      bool operator<(const Rank& o) const {
+         return pos < o.pos;
+      }
+   };
+
+   ///records, that are read or written at once
+   static const size_t StreamBlock = 1 << 12;
+   ///count of runs, that are merged at once
+   static const size_t MaxOpenRuns = 64;
+   ///marks a suffix, whose group is not sorted yet
+   static const uint64_t Mark = uint64_t(1) << (8 * sizeof(idxT) - 1);
+
+   ///order-preserving unsigned code of a character
+   static ualph code(const alph& c){
+      return ualph(c) ^ (std::is_signed<alph>::value ? ualph(ualph(1) << (8 * sizeof(alph) - 1)) : ualph(0));
+   }
+
+   ///writes records of type *Rec* to a file in blocks
+   template<typename Rec>
+   class Writer{
+   public:
+      explicit Writer(const std::string& f_name)
+      : name(f_name), out(f_name, std::ios::binary), written(0)
+      {
+         if(!out.is_open()){
+            std::cerr << "ERROR : Failed to create temporary file ''" << name << "''\n";
+            exit(1);
+         }
+         buf.reserve(StreamBlock);
+      }
+
+      void put(const Rec& r){
+         buf.push_back(r);
+         if(buf.size() == StreamBlock)
+            flush();
+      }
+
+      ///writes the rest of the records, returns the count of records in the file
+      uint64_t close(){
+         flush();
+         out.close();
+         if(!out){
+            std::cerr << "ERROR : Failed to write temporary file ''" << name << "''\n";
+            exit(1);
+         }
+         return written;
+      }
+
+   private:
+      void flush(){
+         if(buf.size())
+            out.write((const char*)&buf[0], sizeof(Rec) * buf.size());
+         written += buf.size();
+         buf.clear();
+      }
+
+      const std::string name;
+      std::ofstream out;
+      std::vector<Rec> buf;
+      uint64_t written;
+   };
+
+   ///reads records of type *Rec* from a file in blocks, starting with record *first*
+   template<typename Rec>
+   class Reader{
+   public:
+      explicit Reader(const std::string& f_name, const uint64_t& first=0)
+      : in(f_name, std::ios::binary), at(0)
+      {
+         if(!in.is_open()){
+            std::cerr << "ERROR : Failed to read temporary file ''" << f_name << "''\n";
+            exit(1);
+         }
+         in.seekg(first * sizeof(Rec));
+      }
+
+      ///reads the next record into *r*, false at the end of the file
+      bool next(Rec& r){
+         if(at == buf.size()){
+            buf.resize(StreamBlock);
+            in.read((char*)&buf[0], sizeof(Rec) * StreamBlock);
+            buf.resize(in.gcount() / sizeof(Rec));
+            at = 0;
+            if(buf.empty())
+               return false;
+         }
+         r = buf[at++];
+         return true;
+      }
+
+   private:
+      std::ifstream in;
+      std::vector<Rec> buf;
+      size_t at;
+   };
+
+   std::string tmpName(const std::string& what, const size_t& i=0) const {
+      std::stringstream buf;
+      buf << dir << "/SA_" << what << '_' << getpid() << '_' << i << ".tmp";
+      return buf.str();
+   }
+
+   void filterNewlines(const std::string& in_f, const std::string& text_f) const {
+      std::ifstream in(in_f, std::ios::binary);
+      if(!in.is_open()){
+         std::cerr << "ERROR : Failed to read input-corpus-file\n";
+         exit(1);
+      }
+      std::ofstream out(text_f, std::ios::binary);
+      if(!out.is_open()){
+         std::cerr << "ERROR : Failed to create temporary file ''" << text_f << "''\n";
+         exit(1);
+      }
+      for(std::istreambuf_iterator<char> i(in), e ; i != e ; ++i){
+         if((*i) != '\n')
+            out.put(*i);
+      }
+   }
+
+   ///sorts the records of the file *f_name* in place: runs of the memory-cap are sorted in memory,
+   ///then up to *MaxOpenRuns* runs are merged at once, until one run is left
+   template<typename Rec>
+   void sortFile(const std::string& f_name) const {
+      const size_t per_run = cap / sizeof(Rec);
+      std::vector<std::string> runs;
+      {
+         Reader<Rec> in(f_name);
+         std::vector<Rec> buf;
+         buf.reserve(per_run);
+         Rec r;
+         bool more = true;
+         while(more){
+            buf.clear();
+            while(buf.size() < per_run && (more = in.next(r)))
+               buf.push_back(r);
+            if(buf.empty())
+               break;
+            if(p_mode)
+               tbb::parallel_sort(buf.begin(), buf.end());
+            else
+               std::sort(buf.begin(), buf.end());
+            runs.push_back(tmpName("run", runs.size()));
+            Writer<Rec> w(runs.back());
+            for(const Rec& x : buf)
+               w.put(x);
+            w.close();
+         }
+      }
+      std::remove(f_name.c_str());
+      if(runs.empty()){
+         Writer<Rec>(f_name).close();
+         return;
+      }
+      ///the blocks of the merged runs and of the output fit into the memory-cap
+      const size_t fan_in = std::max<size_t>(2, std::min<size_t>(MaxOpenRuns, cap / (StreamBlock * sizeof(Rec)) - 1));
+      for(unsigned pass = 1 ; runs.size() > 1 ; ++pass){
+         std::vector<std::string> merged;
+         for(size_t first = 0 ; first < runs.size() ; first += fan_in){
+            const size_t last = std::min(first + fan_in, runs.size());
+            merged.push_back(runs.size() <= fan_in ? f_name : tmpName("run" + std::to_string(pass), merged.size()));
+            mergeRuns<Rec>(runs, first, last, merged.back());
+         }
+         runs.swap(merged);
+      }
+      if(runs[0] != f_name && std::rename(runs[0].c_str(), f_name.c_str())){
+         std::cerr << "ERROR : Failed to write temporary file ''" << f_name << "''\n";
+         exit(1);
+      }
+   }
+
+   ///merges the sorted runs [first, last) into the file *f_name* and removes them
+   template<typename Rec>
+   void mergeRuns(const std::vector<std::string>& runs,
+                  const size_t& first,
+                  const size_t& last,
+                  const std::string& f_name) const {
+      std::vector<std::unique_ptr<Reader<Rec>>> in;
+      typedef std::pair<Rec, size_t> Head;
+      auto greater = [](const Head& a, const Head& b){
+         return b.first < a.first;
+      };
+      std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+      for(size_t r = first ; r < last ; ++r){
+         in.emplace_back(new Reader<Rec>(runs[r]));
+         Rec x;
+         if(in.back()->next(x))
+            heads.push(Head(x, r - first));
+      }
+      Writer<Rec> out(f_name);
+      while(!heads.empty()){
+         Head h = heads.top();
+         heads.pop();
+         out.put(h.first);
+         if(in[h.second]->next(h.first))
+            heads.push(h);
+      }
+      out.close();
+      for(size_t r = first ; r < last ; ++r)
+         std::remove(runs[r].c_str());
+   }
+
+   ///sorts the suffixes by their first characters, packed into one number, and writes the first ranks,
+   ///returns the count of characters, that are sorted
+   uint64_t firstRound(const alph* T, const idxT& n, const std::string& ranks_f) const {
+      ualph min = code(T[0]), max = code(T[0]);
+      for(idxT i = 1 ; i < n ; ++i){
+         min = std::min(min, code(T[i]));
+         max = std::max(max, code(T[i]));
+      }
+      ///0 is the end of the input
+      const uint64_t sigma = uint64_t(max - min) + 2;
+      uint64_t k = 1;
+      uint64_t range = sigma;
+      while(k < n && range <= uint64_t(idxT(-1)) / sigma){
+         range *= sigma;
+         ++k;
+      }
+      const std::string tuples_f = tmpName("tuples");
+      Writer<Triple> tuples(tuples_f);
+      for(uint64_t i = 0 ; i < n ; ++i){
+         uint64_t key = 0;
+         for(uint64_t j = i ; j < i + k ; ++j)
+            key = key * sigma + (j < n ? uint64_t(code(T[j]) - min) + 1 : 0);
+         tuples.put(Triple{idxT(1), idxT(key), idxT(i)});
+      }
+      tuples.close();
+      ///all suffixes are in the group of rank 1
+      Writer<idxT> ranks(ranks_f);
+      for(uint64_t i = 0 ; i < n ; ++i)
+         ranks.put(idxT(1 | Mark));
+      ranks.close();
+      refineGroups(tuples_f, ranks_f);
+      return k;
+   }
+
+   ///doubles *h*, until every suffix has its own rank
+   void doubling(const idxT& n, uint64_t h, const std::string& ranks_f) const {
+      const std::string tuples_f = tmpName("tuples");
+      while(true){
+         ///the group of every marked suffix is refined by the rank *h* positions further
+         Reader<idxT> ranks(ranks_f), further(ranks_f, h);
+         Writer<Triple> tuples(tuples_f);
+         idxT r, s;
+         for(uint64_t i = 0 ; ranks.next(r) ; ++i){
+            const bool next = i + h < n && further.next(s);
+            if(uint64_t(r) & Mark)
+               tuples.put(Triple{idxT(uint64_t(r) & ~Mark), next ? idxT(uint64_t(s) & ~Mark) : idxT(0), idxT(i)});
+         }
+         if(!tuples.close()){
+            std::remove(tuples_f.c_str());
+            return;
+         }
+         refineGroups(tuples_f, ranks_f);
+         h <<= 1;
+      }
+   }
+
+   ///sorts the records of *tuples_f* and writes the new ranks of their suffixes into *ranks_f*,
+   ///the rank of a suffix is its group and the count of suffixes of the group with a smaller key
+   void refineGroups(const std::string& tuples_f, const std::string& ranks_f) const {
+      sortFile<Triple>(tuples_f);
+      const std::string updates_f = tmpName("updates");
+      {
+         Reader<Triple> in(tuples_f);
+         Writer<Rank> out(updates_f);
+         Triple cur, next;
+         bool has = in.next(cur), prev_same = false;
+         uint64_t offset = 0, start = 0;
+         while(has){
+            const bool has_next = in.next(next);
+            const bool next_same = has_next && next.group == cur.group && next.key == cur.key;
+            if(!prev_same)
+               start = offset;
+            const uint64_t rank = uint64_t(cur.group) + start;
+            out.put(Rank{cur.pos, idxT(prev_same || next_same ? rank | Mark : rank)});
+            offset = has_next && next.group == cur.group ? offset + 1 : 0;
+            prev_same = next_same;
+            cur = next;
+            has = has_next;
+         }
+         out.close();
+      }
+      std::remove(tuples_f.c_str());
+      ///the new ranks replace the ones of their suffixes
+      sortFile<Rank>(updates_f);
+      const std::string new_f = tmpName("newranks");
+      {
+         Reader<idxT> ranks(ranks_f);
+         Reader<Rank> updates(updates_f);
+         Writer<idxT> out(new_f);
+         Rank u;
+         bool has = updates.next(u);
+         idxT r;
+         for(uint64_t i = 0 ; ranks.next(r) ; ++i){
+            if(has && uint64_t(u.pos) == i){
+               r = u.rank;
+               has = updates.next(u);
+            }
+            out.put(r);
+         }
+         out.close();
+      }
+      std::remove(updates_f.c_str());
+      if(std::rename(new_f.c_str(), ranks_f.c_str())){
+         std::cerr << "ERROR : Failed to write temporary file ''" << ranks_f << "''\n";
+         exit(1);
+      }
+   }
+
+   ///the ranks are the positions in the suffix-array: every scan of the ranks places the suffixes of the next
+   ///ranks, that fit into the memory-cap, and appends them to *out*
+   void writeSuffixes(const idxT& n,
+                      const std::string& ranks_f,
+                      std::ostream& out,
+                      const bool& cmpr,
+                      const idxT& max_idx_size) const {
+      const uint64_t per_scan = std::min<uint64_t>(n, cap / sizeof(idxT));
+      std::vector<idxT> window;
+      window.reserve(per_scan);
+      for(uint64_t first = 1 ; first <= n ; first += per_scan){
+         const uint64_t len = std::min<uint64_t>(per_scan, uint64_t(n) + 1 - first);
+         window.resize(len);
+         Reader<idxT> ranks(ranks_f);
+         idxT r;
+         for(uint64_t i = 0 ; ranks.next(r) ; ++i){
+            if(uint64_t(r) - first < len)
+               window[uint64_t(r) - first] = i;
+         }
+         writeEntries(out, &window[0], len, cmpr, max_idx_size);
+      }
+      std::remove(ranks_f.c_str());
+   }
+
+   ///appends *k* entries of the suffix-array, as binary or hexadecimal strings
+   void writeEntries(std::ostream& out,
+                     const idxT* SA,
+                     const size_t& k,
+                     const bool& cmpr,
+                     const idxT& max_idx_size) const {
+      if(!cmpr){
+         out.write((const char*)SA, sizeof(idxT) * k);
+         return;
+      }
+      for(size_t i = 0 ; i < k ; ++i){
+         out << std::setw(max_idx_size) << std::setfill('0')
+             << std::hex << SA[i];
+      }
+   }
+
+   const std::string dir;
+   const size_t cap;
+   const bool p_mode;
+};
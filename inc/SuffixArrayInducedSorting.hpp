@@ -5,16 +5,8 @@
 #include "string.h"
 #include <algorithm>
 #include <map>
-#include <unordered_map>
-#include <chrono>
 #include "typeChecks.hpp"
 
-typedef std::chrono::time_point<std::chrono::steady_clock> timeT;
-
-void stop_time(const timeT& start, const std::string& s=""){
-   std::cout <<s<< std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-}
-
 ///Template-Function-Object for creating a suffix-array
 template<typename alph=char, typename idxT=size_t>
 class SuffixArrayInducedSorting{
@@ -54,8 +46,6 @@ public:
       ///
       ///The size of the current summary and the size of the alphabet is updated in the template-function *toStack* of type *StackElement*
       
-      auto start(std::chrono::steady_clock::now());
-      
       checkIndexType<idxT>();
       checkDataSizeIdxT<idxT>(alph_cont.size());
       
@@ -64,58 +54,30 @@ public:
       idxT summ_alph_s = max;
       ++summ_alph_s;
       
-      std::cout << "summ_alph_s : " << summ_alph_s<< "\tmin"<< subtract <<'\n';
-      for(auto it = alph_cont.begin() ; it != alph_cont.end() ; ++it){
-         std::cout << *it <<',';
-      }
-      std::cout << '\n';
-      
       FirstStackElement FSE = FirsttoStack(alph_cont,
                                            new_alph_cont,
                                            summ_s,
                                            summ_alph_s);
-      std::cout <<"summ_s : " <<summ_s << '\n';
       std::vector<StackElement> Stack;
       std::vector<idxT> summary;
-      stop_time(start);
-      start = std::chrono::steady_clock::now();
       while(summ_s != summ_alph_s){
-         
-         std::cout << "summ_alph_s : " << summ_alph_s<<'\n';
-         for(auto it = new_alph_cont.begin() ; it != new_alph_cont.end() ; ++it){
-            std::cout << *it <<',';
-         }
-         std::cout << '\n';
-         
          Stack.push_back(toStack(new_alph_cont,
                                  summary,
                                  summ_s,
                                  summ_alph_s));
          new_alph_cont = summary;
       }//while
-      stop_time(start);
-      start = std::chrono::steady_clock::now();
       
       ///3. If every element of the summary is unique, the population of the Stack stops
       ///and the inverse of the summary is created with *RetSummarySA*
-      stop_time(start);
-      start = std::chrono::steady_clock::now();
-      
       Stack.shrink_to_fit();
       summary = RetSummarySA(new_alph_cont);
       
-      stop_time(start);
-      start = std::chrono::steady_clock::now();
       ///4. while the size of the Stack is bigger than 0 *fromStack* of type *StackElement* is called on the last element of the Stack and the summary. The summary is updated with value of *fromStack*
-      stop_time(start);
-      std::cout <<"hier?\n";
-      start = std::chrono::steady_clock::now();
       while(Stack.size()){
          summary = fromStack(Stack.back(), summary);
          Stack.pop_back();
       }//while
-      stop_time(start);
-      std::cout <<"hier?\n";
       ///5. call *fromStack* of type *FirstStackElement* on the stored object of type *FirstStackElement* and the value is returned. (final suffix-array)
       return LastfromStack(FSE, summary);
    }
@@ -150,23 +112,17 @@ private:
       ///3. induce-sort R-Types on result with elements of top of stack
       ///4. return result
       std::vector<idxT> tails_bucket;
-      std::cout << "frST0\n";
       std::vector<idxT> counts = std::get<3>(top);
       make_buckets(tails_bucket, counts, false);
-      std::cout << "frST\n";
       std::vector<idxT> idc = LMSSort(std::get<0>(top), 
                                       tails_bucket, 
                                       std::get<1>(top), 
                                       summarySA, 
                                       std::get<2>(top));
-      std::cout << "frST1\n";
       std::vector<idxT> heads_bucket;
       make_buckets(heads_bucket, counts, true);
-      std::cout << "frST2\n";
       LInduceSort(idc, std::get<0>(top), std::get<1>(top), heads_bucket);
-      std::cout << "frST3\n";
       SInduceSort(idc, std::get<0>(top), std::get<1>(top), tails_bucket);
-      std::cout << "frST4\n";
       return idc;
    }
    
@@ -209,13 +165,8 @@ private:
       ///5. induce sort L-types
       ///6. induce sort S-types
       ///7. make summary, set *summ_s*, set *summ_alph_s* and set indices-array pointing back to summary
-      auto start = std::chrono::steady_clock::now();
       std::vector<bool> STypes = make_STypes(alph_cont);
-      stop_time(start,"\tstypes ");
 
-      start = std::chrono::steady_clock::now();
-      std::unordered_map<idxT, idxT> all_lms;
-      
       std::vector<idxT> counts(summ_alph_s, 0);
       make_counts(alph_cont, counts);
       
@@ -224,29 +175,22 @@ private:
       
       std::vector<idxT> guessedSA = guessSortLMS(alph_cont, 
                                                 STypes, 
-                                                tails_bucket,
-                                                all_lms);
+                                                tails_bucket);
       
-      stop_time(start,"\tguesssort ");
       
       std::vector<idxT> heads_bucket;
       make_buckets(heads_bucket, counts, true);
       LInduceSort(guessedSA, alph_cont, STypes, heads_bucket);
-      stop_time(start,"\tlinduce ");
       
-      start = std::chrono::steady_clock::now();
       SInduceSort(guessedSA, alph_cont, STypes, tails_bucket);
-      stop_time(start,"\tsinduce ");
       
-      start = std::chrono::steady_clock::now();
       std::vector<idxT> summIdc;
       summary = summarizeSA(alph_cont, 
                            guessedSA, 
-                           all_lms, 
                            summ_alph_s,
-                           summIdc);
+                           summIdc,
+                           STypes);
       summ_s = summary.size();
-      stop_time(start,"\tsumm ");
       return std::make_tuple(alph_cont, STypes, summIdc, counts);
    }
    
@@ -265,14 +209,8 @@ private:
       ///5. induce sort L-types
       ///6. induce sort S-types
       ///7. make summary, set *summ_s*, set *summ_alph_s* and set indices-array pointing back to summary
-      auto start = std::chrono::steady_clock::now();
       std::vector<bool> STypes = make_STypes(alph_cont);
-      stop_time(start,"\tstypes ");
 
-      start = std::chrono::steady_clock::now();
-      std::unordered_map<idxT, idxT> all_lms;
-      
-//       std::cout << summ_alph_s << ','<<subtract<<'\n';
       std::vector<idxT> counts(summ_alph_s - subtract, 0);
       make_counts(alph_cont, counts, subtract);
       
@@ -282,31 +220,24 @@ private:
       std::vector<idxT> guessedSA = guessSortLMS(alph_cont, 
                                                 STypes, 
                                                 tails_bucket,
-                                                all_lms,
                                                 subtract);
       
-      stop_time(start,"\tguesssort ");
       
       std::vector<idxT> heads_bucket;
       make_buckets(heads_bucket, counts, true);
       LInduceSort(guessedSA, alph_cont, STypes, heads_bucket,
                                                 subtract);
-      stop_time(start,"\tlinduce ");
       
-      start = std::chrono::steady_clock::now();
       SInduceSort(guessedSA, alph_cont, STypes, tails_bucket,
                                                 subtract);
-      stop_time(start,"\tsinduce ");
       
-      start = std::chrono::steady_clock::now();
       std::vector<idxT> summIdc;
       summary = summarizeSA(alph_cont, 
                            guessedSA, 
-                           all_lms, 
                            summ_alph_s,
-                           summIdc);
+                           summIdc,
+                           STypes);
       summ_s = summary.size();
-      stop_time(start,"\tsumm ");
       return std::make_tuple(alph_cont, STypes, summIdc, counts);
    }
    
@@ -375,26 +306,16 @@ private:
    std::vector<idxT> guessSortLMS(auto alph_cont, 
                                   const std::vector<bool>& STypes,
                                   std::vector<idxT> Tails, 
-                                  std::unordered_map<idxT, idxT>& all_lms,
                                   const idxT& sub=0) const {
       ///the content of this array is later sorted by *LInduceSort*, *SInduceSort*, *LMSSort* and *LInduceSort*, *SInduceSort* again.
       ///induce-sorts all lms-chars from tails to head.
       std::vector<idxT> guessedSA(alph_cont.size()+1, invalid);
-      idxT lms_bef = invalid;
-      idxT i = 0;
-      for( ; i < alph_cont.size() ; ++i){
+      for(idxT i = 0 ; i < alph_cont.size() ; ++i){
          if(idxIsLMSC(i, STypes)){
             guessedSA[Tails[alph_cont[i]-sub]] = i;
-//             std::cout << alph_cont[i]-subtract << '\t' << Tails[alph_cont[i]-subtract]<<'\n';
             --(Tails[alph_cont[i]-sub]);
-            if(lms_bef != invalid){
-               all_lms.insert(std::pair<idxT, idxT>(lms_bef, i));
-            }
-            lms_bef = i;
          }
       }
-      ///modification, lms-chars/substrings are all calculated and stored for later use
-      all_lms.insert(std::pair<idxT, idxT>(lms_bef, i));
       
       guessedSA[0] = alph_cont.size();
       return guessedSA;
@@ -437,47 +358,58 @@ private:
    }
 
    ///function to generate a shorter representation of the input with their corresponding index
-   std::vector<idxT> summarizeSA(auto alph_cont,
+   std::vector<idxT> summarizeSA(const auto& alph_cont,
                                  const std::vector<idxT>& guessedSA,
-                                 const std::unordered_map<idxT, idxT>& all_lms,
                                  idxT& summ_alph_s,
-                                 std::vector<idxT>& summIdc) const {
+                                 std::vector<idxT>& summIdc,
+                                 const std::vector<bool>& STypes) const {
       ///- *summ_alph_s*, the alphabet-size of the shorter representation is set
       ///- *summIdc*, indices pointing back are set
       ///- if *summ_alph_s* differs from the size of the returned array, the recursion(population of the Stack) continues
       ///- compares all lms-substrings for uniqueness, depending on those, the summary is generated
       ///- in worst case summary is half the size of input
+      ///
+      ///The end of a lms-substring is the next lms-char found by scanning *STypes*, 
+      ///the names are stored at index/2 of their lms-char, because lms-chars are never neighbours
+      const idxT n = alph_cont.size();
+      std::vector<idxT> names(n / 2 + 1, invalid);
       
-      std::pair<idxT, idxT> lms_bef(guessedSA[0], guessedSA[0]);
-      std::vector<idxT> lms(alph_cont.size() + 1, invalid);
-      
+      ///the empty suffix (guessedSA[0]) is the only lms-substring ending at n and gets name 0
       idxT cur_name = 0;
-      lms[guessedSA[0]] = cur_name;
-      
-      std::vector<idxT> summ;
-      summ.reserve(all_lms.size());
-      summIdc.reserve(all_lms.size());
+      idxT lms_bef_fir = n, lms_bef_sec = n;
+      idxT lms_count = 0;
       
       for(idxT i = 1 ; i < guessedSA.size() ; ++i){
-         auto lms_pair = all_lms.find(guessedSA[i]);
-         if(lms_pair != all_lms.end()){
-            if(!std::equal(alph_cont.begin() + lms_bef.first, 
-                           alph_cont.begin() + lms_bef.second, 
-                           alph_cont.begin() + lms_pair->first, 
-                           alph_cont.begin() + lms_pair->second)){
+         idxT lms_i = guessedSA[i];
+         if(idxIsLMSC(lms_i, STypes)){
+            idxT lms_end = lms_i + 1;
+            while(!idxIsLMSC(lms_end, STypes))
+               ++lms_end;
+            if(lms_end == n || lms_bef_sec == n ||
+               lms_end - lms_i != lms_bef_sec - lms_bef_fir ||
+               !std::equal(alph_cont.begin() + lms_i, 
+                           alph_cont.begin() + lms_end + 1, 
+                           alph_cont.begin() + lms_bef_fir)){
                ++cur_name;
             }
-            lms[guessedSA[i]] = cur_name;
-            lms_bef = *lms_pair;
+            names[lms_i >> 1] = cur_name;
+            lms_bef_fir = lms_i;
+            lms_bef_sec = lms_end;
+            ++lms_count;
          }
       }
-
-      for(idxT i = 0 ; i < lms.size() ; ++i){
-         if(lms[i] != invalid){
-            summ.push_back(lms[i]);
+      
+      std::vector<idxT> summ;
+      summ.reserve(lms_count + 1);
+      summIdc.reserve(lms_count + 1);
+      for(idxT i = 1 ; i < n ; ++i){
+         if(idxIsLMSC(i, STypes)){
+            summ.push_back(names[i >> 1]);
             summIdc.push_back(i);
          }
       }
+      summ.push_back(0);
+      summIdc.push_back(n);
       summ_alph_s = cur_name+1;
       return summ;
    }
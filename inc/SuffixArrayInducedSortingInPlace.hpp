@@ -0,0 +1,458 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "typeChecks.hpp"
+#include "BuildContext.hpp"
+
+///Template-Function-Object for creating a suffix-array with constant extra space
+template<typename alph=char, typename idxT=size_t>
+class SuffixArrayInducedSortingInPlace{
+   ///This is the SA-IS-algorithm of G.Nong, S. Zhang and W.H. Chan, in the space-saving formulation of Y. Mori's "sais".
+   ///
+   ///- typename *alph*
+   ///> type of elements of the input-vector
+   ///
+   ///- typename idxT
+   ///> determines type of indices, stored in the final suffix-array
+   ///
+   ///Unlike *SuffixArrayInducedSorting* there is no Stack of copied summaries and no L-S-Type-array.
+   ///Types are derived on the fly from neighbouring characters,
+   ///every reduced problem (summary and its suffix-array) is stored in the unused part of the output-array
+   ///and the buckets of the first recursion-step take O(alphabet-size) words.
+   ///Deeper recursion-steps store their buckets in the free tail of the output-array, if there is enough space.
+   ///
+   ///The highest bit of *idxT* is used to mark indices during sorting, so the input must be smaller than half of the range of *idxT*.
+   ///
+   ///With a *BuildContext* the output-array and the allocated buckets are taken from its pools.
+public:
+   ///- *operator()*, takes a *std::vector* of type *alph* as argument
+   ///- returns a *std::vector* of type *idxT* (final suffix-array)
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max) const {
+      checkIndexType<idxT>();
+      checkDataSizeInPlace(alph_cont.size());
+
+      ///1. the output-array is the only n-word allocation, position 0 is the empty suffix
+      std::vector<idxT> SA = takeBuffer<idxT>(ctx, alph_cont.size()+1, 0);
+      SA[0] = alph_cont.size();
+      if(alph_cont.size() < 2){
+         if(alph_cont.size())
+            SA[1] = 0;
+         return SA;
+      }
+      ///2. sort the non-empty suffixes into the rest of the output-array
+      sais(Text<alph>(&alph_cont[0], subtract),
+           &SA[1],
+           0,
+           alph_cont.size(),
+           max - subtract + 1);
+      return SA;
+   }
+
+   ///constructor sets the invalid index to max of idxT, the mark to the highest bit of idxT and the optional context, whose buffers are used
+   SuffixArrayInducedSortingInPlace(const idxT& min, BuildContext* context=nullptr)
+   : invalid(-1), mark_bit(invalid - (invalid >> 1)), subtract(min), ctx(context)
+   {}
+
+private:
+   ///smallest alphabet-size, for which the buckets are placed into the free tail of the output-array
+   static const unsigned MinBucketSize = 256;
+
+   ///read-only view of the current input, characters are shifted by *sub*, so they start at 0
+   template<typename charT>
+   struct Text{
+   public:
+      Text(const charT* beg, const idxT& sub)
+      : cont(beg), sub(sub)
+      {}
+
+      idxT operator[](const idxT& i) const {
+         return idxT(cont[i]) - sub;
+      }
+   private:
+      const charT* cont;
+      idxT sub;
+   };
+
+   ///checks if the biggest index (input-data-byte-count) leaves the highest bit of idxT unused
+   void checkDataSizeInPlace(const size_t& data_size) const {
+      if(data_size >= (invalid >> 1)){
+         std::cerr << "ERROR : Input has too many positions for index-type(idxT) of the in-place induced-sorting!!!\n";
+         exit(1);
+      }
+   }
+
+   ///marks an index or removes the mark of an index
+   idxT mark(const idxT& i) const {
+      return invalid - i;
+   }
+
+   bool isMarked(const idxT& i) const {
+      return i & mark_bit;
+   }
+
+   ///an index is positive, if it is neither 0 nor marked
+   bool isPositive(const idxT& i) const {
+      return i && !isMarked(i);
+   }
+
+   template<typename textT>
+   void getCounts(const textT& T, idxT* C, const idxT& n, const idxT& k) const {
+      std::fill(C, C + k, 0);
+      for(idxT i = 0 ; i < n ; ++i)
+         ++C[T[i]];
+   }
+
+   ///*end* decides, if the buckets point to the ends or to the beginnings
+   void getBuckets(const idxT* C, idxT* B, const idxT& k, const bool& end) const {
+      idxT sum = 0;
+      if(end){
+         for(idxT i = 0 ; i < k ; ++i){
+            sum += C[i];
+            B[i] = sum;
+         }
+      }
+      else{
+         for(idxT i = 0 ; i < k ; ++i){
+            sum += C[i];
+            B[i] = sum - C[i];
+         }
+      }
+   }
+
+   ///sorts the suffixes of *T* into *SA*, *fs* is the count of free words behind the n words of *SA*, *k* the alphabet-size
+   template<typename textT>
+   void sais(const textT& T,
+             idxT* SA,
+             const idxT& fs,
+             const idxT& n,
+             const idxT& k) const {
+      ///1. place the counts *C* and buckets *B* into the free tail of *SA* or allocate them
+      ///> - flag 1 : *C* allocated, *B* in *SA*
+      ///> - flag 2 : *B* allocated
+      ///> - flag 4 : *C* and *B* share one allocated array
+      ///> - flag 8 : the counts have to be recomputed before inducing
+      std::vector<idxT> C_buf;
+      std::vector<idxT> B_buf;
+      idxT* C;
+      idxT* B;
+      unsigned flags;
+      if(k <= MinBucketSize){
+         C_buf = takeBuffer<idxT>(ctx, k);
+         C = &C_buf[0];
+         if(k <= fs){
+            B = SA + (n + fs - k);
+            flags = 1;
+         }
+         else{
+            B_buf = takeBuffer<idxT>(ctx, k);
+            B = &B_buf[0];
+            flags = 3;
+         }
+      }
+      else if(k <= fs){
+         C = SA + (n + fs - k);
+         if(k <= fs - k){
+            B = C - k;
+            flags = 0;
+         }
+         else if(k <= MinBucketSize * 4){
+            B_buf = takeBuffer<idxT>(ctx, k);
+            B = &B_buf[0];
+            flags = 2;
+         }
+         else{
+            B = C;
+            flags = 8;
+         }
+      }
+      else{
+         C_buf = takeBuffer<idxT>(ctx, k);
+         C = B = &C_buf[0];
+         flags = 4 | 8;
+      }
+
+      ///2. put the predecessors of all LMS-chars into the ends of their buckets
+      getCounts(T, C, n, k);
+      getBuckets(C, B, k, true);
+      std::fill(SA, SA + n, 0);
+      idxT dummy;
+      idxT* b = &dummy;
+      idxT i = n - 1;
+      idxT j = n;
+      idxT m = 0;
+      idxT c0 = T[n - 1];
+      idxT c1;
+      do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+      while(i != invalid){
+         do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) <= c1));
+         if(i != invalid){
+            *b = j;
+            b = SA + --B[c1];
+            j = i;
+            ++m;
+            do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+         }
+      }
+
+      ///3. sort and name all LMS-substrings
+      idxT name;
+      if(1 < m){
+         LMSSort(T, SA, C, B, n, k);
+         name = LMSName(T, SA, n, m);
+      }
+      else if(m == 1){
+         *b = j + 1;
+         name = 1;
+      }
+      else{
+         name = 0;
+      }
+
+      ///4. if the names are not unique, the summary is stored at the end of *SA* and sorted recursively in the front of *SA*
+      if(name < m){
+         if(flags & 4){
+            giveBuffer(ctx, C_buf);
+         }
+         if(flags & 2){
+            giveBuffer(ctx, B_buf);
+         }
+         idxT newfs = (n + fs) - (m * 2);
+         if(!(flags & (1 | 4 | 8))){
+            if((k + name) <= newfs)
+               newfs -= k;
+            else
+               flags |= 8;
+         }
+         idxT* RA = SA + m + newfs;
+         for(i = m + (n >> 1) - 1, j = m - 1 ; m <= i ; --i){
+            if(SA[i])
+               RA[j--] = SA[i] - 1;
+         }
+
+         sais(Text<idxT>(RA, 0), SA, newfs, m, name);
+
+         ///> the summary is replaced by the LMS-indices, the sorted summary is mapped back to them
+         i = n - 1;
+         j = m - 1;
+         c0 = T[n - 1];
+         do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+         while(i != invalid){
+            do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) <= c1));
+            if(i != invalid){
+               RA[j--] = i + 1;
+               do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+            }
+         }
+         for(i = 0 ; i < m ; ++i)
+            SA[i] = RA[SA[i]];
+
+         if(flags & 4){
+            C_buf = takeBuffer<idxT>(ctx, k);
+            C = B = &C_buf[0];
+         }
+         if(flags & 2){
+            B_buf = takeBuffer<idxT>(ctx, k);
+            B = &B_buf[0];
+         }
+      }
+
+      ///5. put the sorted LMS-indices into the ends of their buckets and induce-sort L-Types and S-Types
+      if(flags & 8)
+         getCounts(T, C, n, k);
+      if(1 < m){
+         getBuckets(C, B, k, true);
+         i = m - 1;
+         j = n;
+         idxT p = SA[m - 1];
+         c1 = T[p];
+         do{
+            idxT q = B[c0 = c1];
+            while(q < j)
+               SA[--j] = 0;
+            do{
+               SA[--j] = p;
+               if(--i == invalid)
+                  break;
+               p = SA[i];
+            } while((c1 = T[p]) == c0);
+         } while(i != invalid);
+         while(j)
+            SA[--j] = 0;
+      }
+      induceSA(T, SA, C, B, n, k);
+      giveBuffer(ctx, C_buf);
+      giveBuffer(ctx, B_buf);
+   }
+
+   ///function for induce-sorting all LMS-substrings, the predecessors of the LMS-chars are stored in the ends of their buckets
+   template<typename textT>
+   void LMSSort(const textT& T,
+                idxT* SA,
+                idxT* C,
+                idxT* B,
+                const idxT& n,
+                const idxT& k) const {
+      ///1. L-Types from head to tail, S-Type predecessors are marked, used entries are cleared
+      if(C == B)
+         getCounts(T, C, n, k);
+      getBuckets(C, B, k, false);
+      idxT j = n - 1;
+      idxT c0;
+      idxT c1 = T[j];
+      idxT* b = SA + B[c1];
+      --j;
+      *b++ = (T[j] < c1) ? mark(j) : j;
+      for(idxT i = 0 ; i < n ; ++i){
+         if(isPositive(j = SA[i])){
+            if((c0 = T[j]) != c1){
+               B[c1] = b - SA;
+               b = SA + B[c1 = c0];
+            }
+            --j;
+            *b++ = (T[j] < c1) ? mark(j) : j;
+            SA[i] = 0;
+         }
+         else if(isMarked(j)){
+            SA[i] = mark(j);
+         }
+      }
+      ///2. S-Types from tail to head, the LMS-indices remain marked
+      if(C == B)
+         getCounts(T, C, n, k);
+      getBuckets(C, B, k, true);
+      c1 = 0;
+      b = SA + B[c1];
+      for(idxT i = n - 1 ; i != invalid ; --i){
+         if(isPositive(j = SA[i])){
+            if((c0 = T[j]) != c1){
+               B[c1] = b - SA;
+               b = SA + B[c1 = c0];
+            }
+            --j;
+            *--b = (T[j] > c1) ? mark(j + 1) : j;
+            SA[i] = 0;
+         }
+      }
+   }
+
+   ///function for naming the sorted LMS-substrings, returns the count of different names
+   template<typename textT>
+   idxT LMSName(const textT& T,
+                idxT* SA,
+                const idxT& n,
+                const idxT& m) const {
+      ///1. the *m* marked LMS-indices are moved to the front of *SA*
+      idxT i = 0;
+      idxT j;
+      idxT p;
+      for( ; isMarked(p = SA[i]) ; ++i)
+         SA[i] = mark(p);
+      if(i < m){
+         for(j = i, ++i ; ; ++i){
+            if(isMarked(p = SA[i])){
+               SA[j++] = mark(p);
+               SA[i] = 0;
+               if(j == m)
+                  break;
+            }
+         }
+      }
+
+      ///2. the lengths of all LMS-substrings are stored behind them, LMS-indices are never neighbours, so index/2 is unique
+      i = n - 1;
+      j = n - 1;
+      idxT c0 = T[n - 1];
+      idxT c1;
+      do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+      while(i != invalid){
+         do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) <= c1));
+         if(i != invalid){
+            SA[m + ((i + 1) >> 1)] = j - i;
+            j = i + 1;
+            do{ c1 = c0; } while((--i != invalid) && ((c0 = T[i]) >= c1));
+         }
+      }
+
+      ///3. neighbouring LMS-substrings of equal length and characters get the same name, names start at 1
+      idxT name = 0;
+      idxT q = n;
+      idxT qlen = 0;
+      for(i = 0 ; i < m ; ++i){
+         p = SA[i];
+         idxT plen = SA[m + (p >> 1)];
+         bool diff = true;
+         if((plen == qlen) && ((q + plen) < n)){
+            for(j = 0 ; (j < plen) && (T[p + j] == T[q + j]) ; ++j){}
+            if(j == plen)
+               diff = false;
+         }
+         if(diff){
+            ++name;
+            q = p;
+            qlen = plen;
+         }
+         SA[m + (p >> 1)] = name;
+      }
+      return name;
+   }
+
+   ///function for induce-sorting all suffixes from the sorted LMS-suffixes in the ends of their buckets
+   template<typename textT>
+   void induceSA(const textT& T,
+                 idxT* SA,
+                 idxT* C,
+                 idxT* B,
+                 const idxT& n,
+                 const idxT& k) const {
+      ///1. L-Types from head to tail, entries with a S-Type predecessor are marked
+      if(C == B)
+         getCounts(T, C, n, k);
+      getBuckets(C, B, k, false);
+      idxT j = n - 1;
+      idxT c0;
+      idxT c1 = T[j];
+      idxT* b = SA + B[c1];
+      *b++ = (j && (T[j - 1] < c1)) ? mark(j) : j;
+      for(idxT i = 0 ; i < n ; ++i){
+         j = SA[i];
+         SA[i] = mark(j);
+         if(isPositive(j)){
+            --j;
+            if((c0 = T[j]) != c1){
+               B[c1] = b - SA;
+               b = SA + B[c1 = c0];
+            }
+            *b++ = (j && (T[j - 1] < c1)) ? mark(j) : j;
+         }
+      }
+      ///2. S-Types from tail to head, all marks are removed
+      if(C == B)
+         getCounts(T, C, n, k);
+      getBuckets(C, B, k, true);
+      c1 = 0;
+      b = SA + B[c1];
+      for(idxT i = n - 1 ; i != invalid ; --i){
+         if(isPositive(j = SA[i])){
+            --j;
+            if((c0 = T[j]) != c1){
+               B[c1] = b - SA;
+               b = SA + B[c1 = c0];
+            }
+            *--b = (!j || (T[j - 1] > c1)) ? mark(j) : j;
+         }
+         else{
+            SA[i] = mark(j);
+         }
+      }
+   }
+
+   ///invalid index
+   const idxT invalid;
+   ///highest bit of idxT
+   const idxT mark_bit;
+   const idxT subtract;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
+};
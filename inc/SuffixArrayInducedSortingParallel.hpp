@@ -0,0 +1,545 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "typeChecks.hpp"
+#include "BuildContext.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+///Template-Function-Object for creating a suffix-array with multiple threads
+template<typename alph=char, typename idxT=size_t>
+class SuffixArrayInducedSortingParallel{
+   ///This is the SA-IS-algorithm of G.Nong, S. Zhang and W.H. Chan, parallelized with **TBB**.
+   ///
+   ///- typename *alph*
+   ///> type of elements of the input-vector
+   ///
+   ///- typename idxT
+   ///> determines type of indices, stored in the final suffix-array
+   ///
+   ///Every step that touches the whole input runs in parallel blocks:
+   ///the L-S-Types, the counts, the placement of the LMS-chars and the naming of the LMS-substrings.
+   ///The induce-sort-steps scan the suffix-array block by block. For every block all threads first read
+   ///the characters of the preceding indices (the random accesses into the input), then the block is written
+   ///with one bucket-pointer per thread and bucket, if no written index falls back into the block itself.
+   ///Otherwise the block is written by one thread from the read characters.
+   ///
+   ///With a *BuildContext* every buffer of the build is taken from its pools: the suffix-array, the types, the arrays of the LMS-indices,
+   ///the names, the buckets, the counts of the threads and the read blocks.
+private:
+   ///L-S-Types, one bit for every index, S-Type is 1
+   typedef std::vector<uint64_t> TypeBits;
+public:
+   ///- *operator()*, takes a *std::vector* of type *alph* as argument
+   ///- returns a *std::vector* of type *idxT* (final suffix-array)
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max) const {
+      checkIndexType<idxT>();
+      checkDataSizeIdxT<idxT>(alph_cont.size());
+
+      tbb::task_scheduler_init tbb_init;
+
+      std::vector<idxT> SA = takeBuffer<idxT>(ctx, alph_cont.size()+1, invalid);
+      ///Sets first element of the suffix-array as the empty(smallest) suffix, the rest is sorted in place
+      SA[0] = alph_cont.size();
+      if(alph_cont.size())
+         sais(&alph_cont[0], &SA[1], alph_cont.size(), max - subtract + 1, subtract);
+      return SA;
+   }
+
+   ///constructor sets the invalid index to max of idxT and the optional context, whose buffers are used
+   SuffixArrayInducedSortingParallel(const idxT& min, BuildContext* context=nullptr)
+   : invalid(-1), subtract(min), ctx(context)
+   {}
+
+private:
+   ///count of suffix-array-entries read and written together, multiple of 64
+   static const size_t BlockSize = 1 << 16;
+   ///biggest alphabet for which every thread gets its own bucket-pointers
+   static const size_t MaxThreadBuckets = 1 << 10;
+   ///count of parts every block is split into for writing with multiple threads
+   static const size_t BlockParts = 16;
+
+   bool isS(const TypeBits& types, const idxT& i) const {
+      return (types[i >> 6] >> (i & 63)) & 1;
+   }
+
+   ///checks if an index points to a LMS-char. 0 is never a LMS-char.
+   bool idxIsLMSC(const TypeBits& types, const idxT& i) const {
+      return i && isS(types, i) && !isS(types, i - 1);
+   }
+
+   size_t blockCount(const idxT& n) const {
+      return (n + BlockSize - 1) / BlockSize;
+   }
+
+   ///function for sorting the suffixes of *T* into *SA*, the sentinel (empty suffix) is not stored
+   template<typename charT>
+   void sais(const charT* T,
+             idxT* SA,
+             const idxT& n,
+             const idxT& k,
+             const idxT& sub) const {
+      ///1. L-S-Types, counts and all LMS-indices in order of the input
+      ///2. guess the SA with the LMS-indices at the ends of their buckets
+      ///3. induce sort L-types and S-types, the LMS-substrings are sorted
+      ///4. name the LMS-substrings, if the names are not unique, sort the summary recursively
+      ///> without LMS-chars (only L-Types) the second induce-sort-step alone sorts all suffixes
+      ///5. put the sorted LMS-indices at the ends of their buckets and induce sort L-types and S-types again
+      if(n == 1){
+         SA[0] = 0;
+         return;
+      }
+      TypeBits types = make_STypes(T, n);
+      std::vector<idxT> counts = make_counts(T, n, k, sub);
+      std::vector<idxT> lms = collectLMS(types, n);
+      const idxT m = lms.size();
+
+      std::vector<idxT> Tails;
+      std::vector<idxT> sortedLMS;
+      if(m){
+         Tails = make_buckets(counts, false);
+         fill(SA, n, invalid);
+         for(idxT i = 0 ; i < m ; ++i)
+            SA[--Tails[T[lms[i]] - sub]] = lms[i];
+         induce(T, SA, n, types, counts, sub);
+
+         sortedLMS = collectSortedLMS(SA, n, types, m);
+         std::vector<idxT> summary;
+         idxT summ_alph_s = summarizeSA(T, n, lms, sortedLMS, summary);
+
+         std::vector<idxT> summarySA = takeBuffer<idxT>(ctx, m);
+         if(summ_alph_s < m){
+            sais(&summary[0], &summarySA[0], m, summ_alph_s, 0);
+         }
+         else{
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                              [&](const tbb::blocked_range<size_t>& r){
+               for(size_t i = r.begin() ; i != r.end() ; ++i)
+                  summarySA[summary[i]] = i;
+            });
+         }
+         giveBuffer(ctx, summary);
+         tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                           [&](const tbb::blocked_range<size_t>& r){
+            for(size_t i = r.begin() ; i != r.end() ; ++i)
+               sortedLMS[i] = lms[summarySA[i]];
+         });
+         giveBuffer(ctx, summarySA);
+         giveBuffer(ctx, Tails);
+      }
+      giveBuffer(ctx, lms);
+
+      Tails = make_buckets(counts, false);
+      fill(SA, n, invalid);
+      for(idxT i = m - 1 ; i != invalid ; --i)
+         SA[--Tails[T[sortedLMS[i]] - sub]] = sortedLMS[i];
+      giveBuffer(ctx, sortedLMS);
+      induce(T, SA, n, types, counts, sub);
+      giveBuffer(ctx, types);
+      giveBuffer(ctx, counts);
+      giveBuffer(ctx, Tails);
+   }
+
+   void fill(idxT* SA, const idxT& n, const idxT& val) const {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                        [&](const tbb::blocked_range<size_t>& r){
+         std::fill(SA + r.begin(), SA + r.end(), val);
+      });
+   }
+
+   ///function for creating the L-S-Types in parallel blocks of *BlockSize* indices
+   template<typename charT>
+   TypeBits make_STypes(const charT* T, const idxT& n) const {
+      ///- an index i is S-Type, if (T[i] < T[i+1]) or ((T[i] = T[i+1]) and i+1 is S-Type), n-1 is L-Type
+      ///- every block assumes its last index to be L-Type, if it equals the first index of the next block
+      ///and remembers where this run of equal characters starts
+      ///- from the last to the first block the type of every block-end is resolved, the runs are corrected in parallel
+      TypeBits types = takeBuffer<uint64_t>(ctx, (n + 63) / 64, 0);
+      const size_t blocks = blockCount(n);
+      std::vector<idxT> run_start = takeBuffer<idxT>(ctx, blocks);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t b = r.begin() ; b != r.end() ; ++b){
+            const idxT s = b * BlockSize;
+            const idxT e = std::min<idxT>(n, s + BlockSize);
+            bool S = false;
+            idxT run = e;
+            if(e < n && T[e - 1] == T[e]){
+               run = e - 1;
+               for(idxT i = e - 2 ; i != idxT(s - 1) ; --i){
+                  if(T[i] != T[i + 1])
+                     break;
+                  run = i;
+               }
+            }
+            for(idxT i = e - 1 ; i != idxT(s - 1) ; --i){
+               if(i + 1 < n){
+                  if(T[i] < T[i + 1])
+                     S = true;
+                  else if(T[i] > T[i + 1])
+                     S = false;
+               }
+               if(S)
+                  types[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+            run_start[b] = run;
+         }
+      });
+      std::vector<unsigned char> fix_S = takeBuffer<unsigned char>(ctx, blocks, 0);
+      bool next_S = false;
+      for(size_t b = blocks ; b-- ; ){
+         const idxT s = b * BlockSize;
+         fix_S[b] = next_S;
+         next_S = run_start[b] == s ? next_S : isS(types, s);
+      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t b = r.begin() ; b != r.end() ; ++b){
+            if(!fix_S[b])
+               continue;
+            const idxT e = std::min<idxT>(n, (b + 1) * BlockSize);
+            for(idxT i = run_start[b] ; i < e ; ++i)
+               types[i >> 6] |= uint64_t(1) << (i & 63);
+         }
+      });
+      giveBuffer(ctx, run_start);
+      giveBuffer(ctx, fix_S);
+      return types;
+   }
+
+   ///function for counting all characters, every part of the input is counted into its own counts in parallel, if the alphabet is small enough
+   template<typename charT>
+   std::vector<idxT> make_counts(const charT* T,
+                                 const idxT& n,
+                                 const idxT& k,
+                                 const idxT& sub) const {
+      std::vector<idxT> counts = takeBuffer<idxT>(ctx, k, 0);
+      if(k > MaxThreadBuckets){
+         for(idxT i = 0 ; i < n ; ++i)
+            ++counts[T[i] - sub];
+         return counts;
+      }
+      std::vector<idxT> part_counts = takeBuffer<idxT>(ctx, BlockParts * k, 0);
+      const size_t part_len = (size_t(n) + BlockParts - 1) / BlockParts;
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, BlockParts),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t p = r.begin() ; p != r.end() ; ++p){
+            const size_t e = std::min<size_t>(n, (p + 1) * part_len);
+            idxT* c = &part_counts[p * k];
+            for(size_t i = p * part_len ; i < e ; ++i)
+               ++c[T[i] - sub];
+         }
+      });
+      for(size_t p = 0 ; p < BlockParts ; ++p){
+         for(idxT c = 0 ; c < k ; ++c)
+            counts[c] += part_counts[p * k + c];
+      }
+      giveBuffer(ctx, part_counts);
+      return counts;
+   }
+
+   ///*heads* decides, if the buckets point to the beginnings or to the ends
+   std::vector<idxT> make_buckets(const std::vector<idxT>& counts, const bool& heads) const {
+      std::vector<idxT> buckets = takeBuffer<idxT>(ctx, counts.size());
+      idxT sum = 0;
+      for(size_t c = 0 ; c < counts.size() ; ++c){
+         if(heads){
+            buckets[c] = sum;
+            sum += counts[c];
+         }
+         else{
+            sum += counts[c];
+            buckets[c] = sum;
+         }
+      }
+      return buckets;
+   }
+
+   ///function for storing all indices *i* < *n* with *pred(i)* in order, in parallel blocks
+   template<typename Pred, typename Val>
+   std::vector<idxT> pack(const idxT& n, const Pred& pred, const Val& val, const idxT& size_hint) const {
+      const size_t blocks = blockCount(n);
+      std::vector<idxT> offsets = takeBuffer<idxT>(ctx, blocks + 1, 0);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t b = r.begin() ; b != r.end() ; ++b){
+            const idxT e = std::min<idxT>(n, (b + 1) * BlockSize);
+            idxT c = 0;
+            for(idxT i = b * BlockSize ; i < e ; ++i){
+               if(pred(i))
+                  ++c;
+            }
+            offsets[b + 1] = c;
+         }
+      });
+      for(size_t b = 0 ; b < blocks ; ++b)
+         offsets[b + 1] += offsets[b];
+      std::vector<idxT> packed = takeBuffer<idxT>(ctx, offsets[blocks]);
+      if(size_hint != invalid && packed.size() != size_hint){
+         std::cerr << "ERROR : count of LMS-chars differs between the steps of the parallel induced-sorting\n";
+         exit(1);
+      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t b = r.begin() ; b != r.end() ; ++b){
+            const idxT e = std::min<idxT>(n, (b + 1) * BlockSize);
+            idxT o = offsets[b];
+            for(idxT i = b * BlockSize ; i < e ; ++i){
+               if(pred(i))
+                  packed[o++] = val(i);
+            }
+         }
+      });
+      giveBuffer(ctx, offsets);
+      return packed;
+   }
+
+   ///all LMS-indices in order of the input
+   std::vector<idxT> collectLMS(const TypeBits& types, const idxT& n) const {
+      return pack(n,
+                  [&](const idxT& i){ return idxIsLMSC(types, i); },
+                  [](const idxT& i){ return i; },
+                  invalid);
+   }
+
+   ///all LMS-indices in order of the (guessed) suffix-array
+   std::vector<idxT> collectSortedLMS(const idxT* SA,
+                                      const idxT& n,
+                                      const TypeBits& types,
+                                      const idxT& m) const {
+      return pack(n,
+                  [&](const idxT& i){ return SA[i] != invalid && idxIsLMSC(types, SA[i]); },
+                  [&](const idxT& i){ return SA[i]; },
+                  m);
+   }
+
+   ///function to generate the summary (names of the LMS-substrings in order of the input), returns the count of different names
+   template<typename charT>
+   idxT summarizeSA(const charT* T,
+                    const idxT& n,
+                    const std::vector<idxT>& lms,
+                    const std::vector<idxT>& sortedLMS,
+                    std::vector<idxT>& summary) const {
+      ///- the length of every LMS-substring (including the next LMS-char) is stored at index/2, LMS-chars are never neighbours
+      ///- neighbouring LMS-substrings in *sortedLMS* are compared in parallel, a differing substring starts a new name
+      ///- the last LMS-substring contains the sentinel and always gets a new name
+      const idxT m = lms.size();
+      std::vector<idxT> half = takeBuffer<idxT>(ctx, n / 2 + 1, 0);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t i = r.begin() ; i != r.end() ; ++i)
+            half[lms[i] >> 1] = (i + 1 < m ? lms[i + 1] : n) - lms[i] + 1;
+      });
+      const idxT last = lms[m - 1];
+      std::vector<idxT> names = takeBuffer<idxT>(ctx, m);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t i = r.begin() ; i != r.end() ; ++i){
+            if(!i){
+               names[i] = 1;
+               continue;
+            }
+            const idxT p = sortedLMS[i];
+            const idxT q = sortedLMS[i - 1];
+            const idxT len = half[p >> 1];
+            names[i] = (p == last || q == last || len != half[q >> 1] ||
+                        !std::equal(T + p, T + p + len, T + q)) ? 1 : 0;
+         }
+      });
+      ///prefix sum of the new-name-flags, blocks in parallel
+      const size_t blocks = blockCount(m);
+      std::vector<idxT> offsets = takeBuffer<idxT>(ctx, blocks + 1, 0);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t b = r.begin() ; b != r.end() ; ++b){
+            const idxT e = std::min<idxT>(m, (b + 1) * BlockSize);
+            idxT sum = 0;
+            for(idxT i = b * BlockSize ; i < e ; ++i){
+               sum += names[i];
+               names[i] = sum;
+            }
+            offsets[b + 1] = sum;
+         }
+      });
+      for(size_t b = 0 ; b < blocks ; ++b)
+         offsets[b + 1] += offsets[b];
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t i = r.begin() ; i != r.end() ; ++i)
+            half[sortedLMS[i] >> 1] = names[i] + offsets[i / BlockSize] - 1;
+      });
+      giveBuffer(ctx, names);
+      summary = takeBuffer<idxT>(ctx, m);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, m),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t i = r.begin() ; i != r.end() ; ++i)
+            summary[i] = half[lms[i] >> 1];
+      });
+      giveBuffer(ctx, half);
+      const idxT summ_alph_s = offsets[blocks];
+      giveBuffer(ctx, offsets);
+      return summ_alph_s;
+   }
+
+   ///function for both induce-sort-steps, starting with the LMS-indices at the ends of their buckets
+   template<typename charT>
+   void induce(const charT* T,
+               idxT* SA,
+               const idxT& n,
+               const TypeBits& types,
+               const std::vector<idxT>& counts,
+               const idxT& sub) const {
+      ///1. the sentinel induces n-1, then L-Types from head to tail
+      ///2. S-Types from tail to head
+      std::vector<idxT> Heads = make_buckets(counts, true);
+      SA[Heads[T[n - 1] - sub]++] = n - 1;
+      induceBlocks(T, SA, n, types, Heads, sub, false);
+      giveBuffer(ctx, Heads);
+
+      std::vector<idxT> Tails = make_buckets(counts, false);
+      induceBlocks(T, SA, n, types, Tails, sub, true);
+      giveBuffer(ctx, Tails);
+   }
+
+   ///function for one induce-sort-step, block by block
+   template<typename charT>
+   void induceBlocks(const charT* T,
+                     idxT* SA,
+                     const idxT& n,
+                     const TypeBits& types,
+                     std::vector<idxT>& buckets,
+                     const idxT& sub,
+                     const bool& STypes) const {
+      ///1. read : for every entry j of the block, the bucket of j-1 is stored, if j-1 has to be induced in this step
+      ///2. write : with one bucket-pointer per part of the block in parallel, if no index is written into the block,
+      ///otherwise in scan-order, entries changed since reading are read again
+      const idxT k = buckets.size();
+      const bool thread_buckets = k <= MaxThreadBuckets;
+      std::vector<idxT> read_pos = takeBuffer<idxT>(ctx, size_t(BlockSize));
+      std::vector<idxT> read_chr = takeBuffer<idxT>(ctx, size_t(BlockSize));
+      std::vector<idxT> part_buckets = takeBuffer<idxT>(ctx, thread_buckets ? BlockParts * k : 0);
+      const size_t blocks = blockCount(n);
+
+      auto bucketOf = [&](const idxT& j) -> idxT {
+         if(j == invalid || !j || isS(types, j - 1) != STypes)
+            return invalid;
+         return T[j - 1] - sub;
+      };
+
+      for(size_t bi = 0 ; bi < blocks ; ++bi){
+         const size_t b = STypes ? blocks - 1 - bi : bi;
+         const idxT s = b * BlockSize;
+         const idxT e = std::min<idxT>(n, s + BlockSize);
+         const idxT len = e - s;
+
+         tbb::parallel_for(tbb::blocked_range<size_t>(0, len, 1 << 12),
+                           [&](const tbb::blocked_range<size_t>& r){
+            for(size_t i = r.begin() ; i != r.end() ; ++i){
+               read_pos[i] = SA[s + i];
+               read_chr[i] = bucketOf(read_pos[i]);
+            }
+         });
+
+         if(thread_buckets && writeParallel(SA, s, len, buckets, read_pos, read_chr, part_buckets, STypes))
+            continue;
+
+         if(STypes){
+            for(idxT i = len - 1 ; i != invalid ; --i){
+               const idxT j = SA[s + i];
+               const idxT c = j == read_pos[i] ? read_chr[i] : bucketOf(j);
+               if(c != invalid)
+                  SA[--buckets[c]] = j - 1;
+            }
+         }
+         else{
+            for(idxT i = 0 ; i < len ; ++i){
+               const idxT j = SA[s + i];
+               const idxT c = j == read_pos[i] ? read_chr[i] : bucketOf(j);
+               if(c != invalid)
+                  SA[buckets[c]++] = j - 1;
+            }
+         }
+      }
+      giveBuffer(ctx, read_pos);
+      giveBuffer(ctx, read_chr);
+      giveBuffer(ctx, part_buckets);
+   }
+
+   ///function for writing one read block with one bucket-pointer per part and bucket, returns false if an index would be written into the block
+   bool writeParallel(idxT* SA,
+                      const idxT& s,
+                      const idxT& len,
+                      std::vector<idxT>& buckets,
+                      const std::vector<idxT>& read_pos,
+                      const std::vector<idxT>& read_chr,
+                      std::vector<idxT>& part_buckets,
+                      const bool& STypes) const {
+      const idxT k = buckets.size();
+      const idxT part_len = (len + BlockParts - 1) / BlockParts;
+      std::fill(part_buckets.begin(), part_buckets.end(), 0);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, BlockParts),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t p = r.begin() ; p != r.end() ; ++p){
+            const idxT e = std::min<idxT>(len, (p + 1) * part_len);
+            idxT* cnt = &part_buckets[p * k];
+            for(idxT i = p * part_len ; i < e ; ++i){
+               if(read_chr[i] != invalid)
+                  ++cnt[read_chr[i]];
+            }
+         }
+      });
+      ///turn the counts into the first (L-Types) or last (S-Types) position of every part and check the written ranges against the block
+      for(idxT c = 0 ; c < k ; ++c){
+         idxT pos = buckets[c];
+         for(size_t pi = 0 ; pi < BlockParts ; ++pi){
+            const size_t p = STypes ? BlockParts - 1 - pi : pi;
+            const idxT cnt = part_buckets[p * k + c];
+            part_buckets[p * k + c] = pos;
+            pos = STypes ? pos - cnt : pos + cnt;
+         }
+         const idxT lo = STypes ? pos : buckets[c];
+         const idxT hi = STypes ? buckets[c] : pos;
+         if(lo < hi && lo < s + len && s < hi)
+            return false;
+      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, BlockParts),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t p = r.begin() ; p != r.end() ; ++p){
+            const idxT b = p * part_len;
+            const idxT e = std::min<idxT>(len, b + part_len);
+            idxT* ptr = &part_buckets[p * k];
+            if(b >= e)
+               continue;
+            if(STypes){
+               for(idxT i = e - 1 ; i != idxT(b - 1) ; --i){
+                  if(read_chr[i] != invalid)
+                     SA[--ptr[read_chr[i]]] = read_pos[i] - 1;
+               }
+            }
+            else{
+               for(idxT i = b ; i < e ; ++i){
+                  if(read_chr[i] != invalid)
+                     SA[ptr[read_chr[i]]++] = read_pos[i] - 1;
+               }
+            }
+         }
+      });
+      ///the bucket-pointers continue behind the last part
+      for(idxT c = 0 ; c < k ; ++c){
+         const size_t p = STypes ? 0 : BlockParts - 1;
+         buckets[c] = part_buckets[p * k + c];
+      }
+      return true;
+   }
+
+   ///invalid index
+   const idxT invalid;
+   const idxT subtract;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
+};
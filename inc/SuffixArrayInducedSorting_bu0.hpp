@@ -2,11 +2,18 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <array>
+#include <tuple>
+#include <type_traits>
 #include "string.h"
 #include <algorithm>
 #include <map>
 #include <unordered_map>
 #include "typeChecks.hpp"
+#include "LSTypeBits.hpp"
+#include "BuildContext.hpp"
+#include "BuildStats.hpp"
+#include "BuildCheckpoint.hpp"
 
 
 #include <chrono>
@@ -23,86 +30,210 @@ class SuffixArrayInducedSorting{
    ///> determines type of indices, stored in the final suffix-array
    ///
    /// Using a Stack instead of explicit recursion
+   ///
+   ///With a *BuildContext* every buffer (including the Stack and the returned suffix-array) is taken from its pools,
+   ///repeated builds of inputs up to the same size do not allocate.
+   ///With *BuildStats* the phases of every recursion-step are recorded, level 0 is the input.
+   ///With a *BuildCheckpoint* every level is stored after it is sorted, a resumed build restores the stored levels
+   ///and continues below the deepest one or above the lowest level, whose suffix-array is stored.
+   ///
+   ///Optionally the lcp-array is induced together with the suffix-array of the input (see *LMSLCP* and *LInduceSortLCP*),
+   ///as described by J. Fischer in "Inducing the LCP-Array".
 private:
    ///every element in the Stack is a 4-tuple
    ///1. *std::vector* of type *idxT*, representing the current suffix-array
-   ///2. *std::vector* of type *bool*, representing if a index is S-Type or L-Type
+   ///2. *LSTypeBits*, representing if a index is S-Type or L-Type and if it is a LMS-char
    ///3. *std::vector* of type *idxT*, representing the "pointer-vector", pointing back to the suffix-array in the previous recursion-step(or the previous element in the Stack)
    ///4. *std::vector* of type *idxT* holding all counts of the current *alph_cont*
    typedef std::tuple<std::vector<idxT>,
-                     std::vector<bool>,
+                     LSTypeBits<idxT>,
                      std::vector<idxT>,
                      std::vector<idxT>>
            StackElement;
-   ///same as StackElement with one differences,
-   ///in the very first recursion call the input is a vector of type *alph*. 
+   ///size of a byte-alphabet
+   static const size_t ByteSigma = 256;
+   ///counts and buckets of the first recursion-step, if *alph* is a byte:
+   ///a fixed array with one entry per byte, indexed by the byte itself (no offset *subtract*)
+   typedef std::array<idxT, ByteSigma> ByteBuckets;
+   typedef typename std::conditional<std::is_same<alph, unsigned char>::value,
+                                     ByteBuckets,
+                                     std::vector<idxT>>::type
+           FirstBuckets;
+   ///same as StackElement with three differences,
+   ///in the very first recursion call the input is a vector of type *alph*, that is not copied, only a pointer to it is stored. 
    ///We do not know how the different elements of the input-vector are spread. 
    ///Within the recursion, the elements of the input-vector always start at 0 and end at the biggest element n. 
    ///All elements are represented within the range(0, n+1)
-   typedef std::tuple<std::vector<alph>,
-                     std::vector<bool>,
+   ///
+   ///The counts of a byte-alphabet are stored in *ByteBuckets*.
+   typedef std::tuple<const std::vector<alph>*,
+                     LSTypeBits<idxT>,
                      std::vector<idxT>,
-                     std::vector<idxT>>
+                     FirstBuckets>
            FirstStackElement;
 public:
    ///- *operator()*, takes a *std::vector* of type *alph* as argument
    ///- returns a *std::vector* of type *idxT* (final suffix-array)
-   std::vector<idxT> operator()(const std::vector<alph> alph_cont, idxT max) const {
-      ///1. the very first call of recursion, an object of type FirstStackElement is created by *toStack* of type *FirstStackElement* and stored.
+   ///- if *lcp* is not *nullptr*, it is set to the lcp-array: *lcp*[i] is the longest common prefix of the suffixes at SA[i] and SA[i+1]
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont, 
+                                idxT max, 
+                                std::vector<idxT>* lcp=nullptr) const {
+      ///1. the very first call of recursion, an object of type FirstStackElement is filled by *toStack* and stored.
       ///2. while the size of the summary differs from the size of the alphabet of the summary (every element in the summary is not unique) then the Stack is populated. 
       ///
-      ///The size of the current summary and the size of the alphabet is updated in the template-function *toStack* of type *StackElement*
-      
-//       auto start(std::chrono::steady_clock::now());
+      ///The size of the current summary and the size of the alphabet is updated in the template-function *toStack*
       ++max;
       
-      std::vector<idxT> new_alph_cont;
+      std::vector<idxT> summary;
       idxT summ_s;
       idxT summ_alph_s = max;
       
-      FirstStackElement FSE = toStack<FirstStackElement, alph>(alph_cont, 
-                                                               new_alph_cont,
-                                                               summ_s,
-                                                               summ_alph_s,
-                                                               subtract);
-//       std::cout << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start = std::chrono::steady_clock::now();
-      std::vector<StackElement> Stack;
-      std::vector<idxT> summary;
-      while(summ_s != summ_alph_s){
-         
-         Stack.push_back(toStack<StackElement, idxT>(new_alph_cont,
-                                                     summary,
-                                                     summ_s,
-                                                     summ_alph_s));
-         new_alph_cont = summary;
+      FirstStackElement FSE;
+      std::get<0>(FSE) = &alph_cont;
+      if(!restoreLevel<alph>(FSE, 0, summary, summ_alph_s, subtract)){
+         toStack<alph>(FSE, 0, summary, summ_s, summ_alph_s, subtract);
+         saveLevel(FSE, 0, summary, summ_alph_s);
+      }
+      summ_s = summary.size();
+      std::vector<StackElement> Stack = takeBuffer<StackElement>(ctx, 0);
+      ///a resumed build stops the descent at the first level, whose suffix-array is stored
+      std::vector<idxT> summarySA;
+      while(summ_s != summ_alph_s && !restoreSorted(Stack.size() + 1, summarySA)){
+         ///the summary of the previous step is the input of the next step
+         Stack.emplace_back();
+         std::get<0>(Stack.back()).swap(summary);
+         if(!restoreLevel<idxT>(Stack.back(), Stack.size(), summary, summ_alph_s)){
+            toStack<idxT>(Stack.back(), Stack.size(), summary, summ_s, summ_alph_s);
+            saveLevel(Stack.back(), Stack.size(), summary, summ_alph_s);
+         }
+         summ_s = summary.size();
       }//while
       
       ///3. If every element of the summary is unique, the population of the Stack stops
       ///and the inverse of the summary is created with *RetSummarySA*
-//       std::cout << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       auto start=std::chrono::steady_clock::now();
-      Stack.shrink_to_fit();
-      summary = RetSummarySA(new_alph_cont);
-//       std::cout << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start =std::chrono::steady_clock::now();
-      ///4. while the size of the Stack is bigger than 0 *fromStack* of type *StackElement* is called on the last element of the Stack and the summary. The summary is updated with value of *fromStack*
+      if(summarySA.empty()){
+         summarySA = RetSummarySA(summary);
+         saveSorted(Stack.size() + 1, summarySA);
+      }
+      giveBuffer(ctx, summary);
+      ///4. while the size of the Stack is bigger than 0 *fromStack* is called on the last element of the Stack and the summary. The summary is updated with value of *fromStack*
       while(Stack.size()){
-         summary = fromStack<StackElement, idxT>(Stack.back(), summary);
+         std::vector<idxT> SA = fromStack<idxT>(Stack.back(), Stack.size(), summarySA);
+         giveBuffer(ctx, summarySA);
+         summarySA.swap(SA);
+         saveSorted(Stack.size(), summarySA);
          Stack.pop_back();
       }//while
-//       std::cout << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-      ///5. call *fromStack* of type *FirstStackElement* on the stored object of type *FirstStackElement* and the value is returned. (final suffix-array)
-      return fromStack<FirstStackElement, alph>(FSE, summary, subtract);
+      giveBuffer(ctx, Stack);
+      ///5. call *fromStack* on the stored object of type *FirstStackElement* and the value is returned. (final suffix-array)
+      std::vector<idxT> SA = fromStack<alph>(FSE, 0, summarySA, subtract, lcp);
+      giveBuffer(ctx, summarySA);
+      if(checkpoint)
+         checkpoint->clear();
+      return SA;
    }
    
-   ///constructor sets the invalid index to max of idxT
-   SuffixArrayInducedSorting(const idxT& min)
-   : invalid(-1), subtract(min)
+   ///constructor sets the invalid index to max of idxT, the optional context, whose buffers are used,
+   ///the optional statistics of the phases, the optional checkpoint of the levels
+   ///and if the induce-sort-steps read the buckets of a block ahead (*ahead*, off until its gain is measured on inputs of 1GB and more)
+   SuffixArrayInducedSorting(const idxT& min, 
+                             BuildContext* context=nullptr, 
+                             BuildStats* build_stats=nullptr,
+                             const BuildCheckpoint* build_checkpoint=nullptr,
+                             const bool& ahead=false)
+   : invalid(-1), subtract(min), ctx(context), stats(build_stats), checkpoint(build_checkpoint), read_ahead(ahead)
    {}
    
 private:
    
+   ///stores the pointer-vector and the summary of a sorted level
+   template<typename StackEl>
+   void saveLevel(const StackEl& el, 
+                  const unsigned& level, 
+                  const std::vector<idxT>& summary, 
+                  const idxT& summ_alph_s) const {
+      if(checkpoint)
+         checkpoint->saveLevel(level, summ_alph_s, std::get<2>(el), summary);
+   }
+   
+   void saveSorted(const unsigned& level, const std::vector<idxT>& SA) const {
+      if(checkpoint)
+         checkpoint->saveSorted(level, SA);
+   }
+   
+   bool restoreSorted(const unsigned& level, std::vector<idxT>& SA) const {
+      return checkpoint && checkpoint->resumes() && checkpoint->loadSorted(level, SA);
+   }
+   
+   ///restores the element of *level* from the checkpoint instead of sorting it: 
+   ///the pointer-vector and the summary are read, the types and the counts are built again from the input of the level
+   template<typename alph_cont_T, typename StackEl>
+   bool restoreLevel(StackEl& el, 
+                     const unsigned& level,
+                     std::vector<idxT>& summary,
+                     idxT& summ_alph_s,
+                     const idxT& min=0) const {
+      idxT next_alph_s;
+      if(!checkpoint || !checkpoint->resumes() || !checkpoint->loadLevel(level, next_alph_s, std::get<2>(el), summary))
+         return false;
+      const std::vector<alph_cont_T>& alph_cont = text(el);
+      PhaseTimer t(stats, BuildPhase::Types, level, alph_cont.size());
+      std::get<1>(el) = LSTypeBits<idxT>(alph_cont, ctx);
+      init_counts(std::get<3>(el), summ_alph_s-min);
+      make_counts(alph_cont, std::get<3>(el), min);
+      summ_alph_s = next_alph_s;
+      return true;
+   }
+   
+   ///checks at compile-time, if the buckets of type *bucketT* are indexed by the bytes themselves
+   template<typename bucketT>
+   static constexpr bool byteBuckets(){
+      return std::is_same<bucketT, ByteBuckets>::value;
+   }
+   
+   ///bucket of the character *c*, the offset *sub* is only subtracted from characters of the generic buckets
+   template<typename bucketT, typename alph_cont_T>
+   static idxT bucketOf(const alph_cont_T& c, const idxT& sub){
+      return byteBuckets<bucketT>() ? idxT(c) : idxT(c - sub);
+   }
+   
+   void init_counts(std::vector<idxT>& counts, const idxT& size) const {
+      counts = takeBuffer<idxT>(ctx, size, 0);
+   }
+   
+   void init_counts(ByteBuckets& counts, const idxT&) const {
+      counts.fill(0);
+   }
+   
+   void release_counts(std::vector<idxT>& counts) const {
+      giveBuffer(ctx, counts);
+   }
+   
+   void release_counts(ByteBuckets&) const {}
+   
+   ///the input of the first step is not owned by the Stack
+   static const std::vector<alph>& text(const FirstStackElement& el){
+      return *std::get<0>(el);
+   }
+   
+   static const std::vector<idxT>& text(const StackElement& el){
+      return std::get<0>(el);
+   }
+   
+   ///hands the buffers of a processed element of the Stack back
+   void release(FirstStackElement& el) const {
+      std::get<1>(el).release(ctx);
+      giveBuffer(ctx, std::get<2>(el));
+      release_counts(std::get<3>(el));
+   }
+   
+   void release(StackElement& el) const {
+      giveBuffer(ctx, std::get<0>(el));
+      std::get<1>(el).release(ctx);
+      giveBuffer(ctx, std::get<2>(el));
+      release_counts(std::get<3>(el));
+   }
+   
    template<typename alph_cont_T>
    void make_counts(const std::vector<alph_cont_T>& alph_cont, std::vector<idxT>& counts, const idxT& sub) const {
       for(auto it = alph_cont.begin() ; it != alph_cont.end() ; ++it){
@@ -110,20 +241,44 @@ private:
       }
    }
    
-   void make_buckets(const std::vector<idxT>& counts, std::vector<idxT>& buckets, const bool& heads) const {
-      buckets.reserve(counts.size());
+   ///histogram of a byte-alphabet: four interleaved streams count into their own tables,
+   ///so increments of the same byte in a row do not wait for each other
+   void make_counts(const std::vector<unsigned char>& alph_cont, ByteBuckets& counts, const idxT&) const {
+      std::array<std::array<uint64_t, ByteSigma>, 4> streams{};
+      const unsigned char* it = alph_cont.data();
+      const unsigned char* end = it + alph_cont.size();
+      for( ; end - it >= 4 ; it += 4){
+         ++streams[0][it[0]];
+         ++streams[1][it[1]];
+         ++streams[2][it[2]];
+         ++streams[3][it[3]];
+      }
+      for( ; it != end ; ++it){
+         ++streams[0][*it];
+      }
+      for(size_t c = 0 ; c < ByteSigma ; ++c){
+         counts[c] = streams[0][c] + streams[1][c] + streams[2][c] + streams[3][c];
+      }
+   }
+   
+   template<typename bucketT>
+   void make_buckets(const bucketT& counts, bucketT& buckets, const bool& heads) const {
+      if(buckets.size() != counts.size())
+         init_counts(buckets, counts.size());
+      std::copy(counts.begin(), counts.end(), buckets.begin());
       if(heads){
          idxT sum = 1;
-         for(auto it = counts.begin() ; it != counts.end() ; ++it){
-            buckets.push_back(sum);
-            sum += (*it);
+         for(auto it = buckets.begin() ; it != buckets.end() ; ++it){
+            const idxT c = (*it);
+            (*it) = sum;
+            sum += c;
          }
       }
       else{
          idxT sum = 0;
-         for(auto it = counts.begin() ; it != counts.end() ; ++it){
+         for(auto it = buckets.begin() ; it != buckets.end() ; ++it){
             sum += (*it);
-            buckets.push_back(sum);
+            (*it) = sum;
          }
       }
    }
@@ -131,8 +286,7 @@ private:
    ///function for creating the inverse vector of type *idxT* of an input-vector of type *idxT*
    ///first position of the inverse vector has to be the index of the empty suffix of the previous summary
    std::vector<idxT> RetSummarySA(const std::vector<idxT>& summary) const {
-      std::vector<idxT> summarySA;
-      summarySA.resize(summary.size()+1, summary.size());
+      std::vector<idxT> summarySA = takeBuffer<idxT>(ctx, summary.size()+1, summary.size());
       for(idxT i = 0 ; i < summary.size() ; ++i){
          summarySA[summary[i]+1] = i;
       }
@@ -141,46 +295,84 @@ private:
    
    
    ///template-function for processing the last element of the Stack
-   template<typename StackEl, typename alph_cont_T>
+   template<typename alph_cont_T, typename StackEl>
    ///takes the last element of the Stack and the current summary as arguments
-   std::vector<idxT> fromStack(const StackEl& top, 
+   std::vector<idxT> fromStack(StackEl& top, 
+                               const unsigned& level,
                                const std::vector<idxT>& summarySA,
-                               const idxT& min=0) const {
+                               const idxT& min=0,
+                               std::vector<idxT>* lcp=nullptr) const {
       ///1. call *LMSSort* on the top of Stack
       ///2. induce-sort L-Types on result of *LMSSort* with elements of top of stack
       ///3. induce-sort R-Types on result with elements of top of stack
-      ///4. return result
+      ///4. hand the buffers of the top of stack back and return result
+      ///
+      ///With *lcp* the lcp-values of the LMS-suffixes are set after *LMSSort* and induced by both induce-sort-steps.
       
-      std::vector<idxT> tails;
+      const std::vector<alph_cont_T>& alph_cont = text(top);
+      typedef typename std::tuple_element<3, StackEl>::type bucketT;
+      bucketT tails;
       make_buckets(std::get<3>(top), tails, false);
-      std::vector<idxT> heads;
-      make_buckets(std::get<3>(top), heads, true);
-      
-      std::vector<idxT> idc = LMSSort<alph_cont_T>
-                                     (std::get<0>(top), 
-                                      tails, 
-                                      std::get<1>(top), 
-                                      summarySA, 
-                                      std::get<2>(top),
-                                      min);
-
-      LInduceSort(idc, std::get<0>(top), std::get<1>(top), heads, min);
-      
-      SInduceSort(idc, std::get<0>(top), std::get<1>(top), tails, min);
+      bucketT heads;
+      std::vector<idxT> idc;
+      {
+         PhaseTimer t(stats, BuildPhase::LMSSort, level, summarySA.size() - 1);
+         idc = LMSSort<alph_cont_T>
+                      (alph_cont, 
+                       tails, 
+                       std::get<1>(top), 
+                       summarySA, 
+                       std::get<2>(top),
+                       min);
+         t.takes(tails);
+         t.takes(idc);
+         if(lcp){
+            LMSLCP(alph_cont, idc, summarySA, std::get<2>(top), *lcp);
+            t.takes(*lcp);
+         }
+      }
+      {
+         PhaseTimer t(stats, BuildPhase::LInduce, level, alph_cont.size());
+         make_buckets(std::get<3>(top), heads, true);
+         if(lcp)
+            LInduceSortLCP(idc, alph_cont, std::get<1>(top), heads, min, *lcp);
+         else
+            LInduceSort(idc, alph_cont, std::get<1>(top), heads, min);
+         t.takes(heads);
+         t.takesBytes(2 * InduceBlockSize * sizeof(idxT));
+      }
+      {
+         PhaseTimer t(stats, BuildPhase::SInduce, level, alph_cont.size());
+         make_buckets(std::get<3>(top), tails, false);
+         if(lcp){
+            make_buckets(std::get<3>(top), heads, true);
+            SInduceSortLCP(idc, alph_cont, std::get<1>(top), tails, heads, min, *lcp);
+         }
+         else
+            SInduceSort(idc, alph_cont, std::get<1>(top), tails, min);
+         t.takesBytes(2 * InduceBlockSize * sizeof(idxT));
+      }
+      ///the lcp-array is induced with the lcp of every suffix and its predecessor, it is returned with the lcp of every suffix and its successor
+      if(lcp)
+         lcp->erase(lcp->begin());
 
+      release_counts(tails);
+      release_counts(heads);
+      release(top);
       return idc;
    }
    
-   ///template-function for generating the element to push onto the Stack
-   template<typename StackEl, typename alph_cont_T>
-   StackEl toStack(std::vector<alph_cont_T> alph_cont, 
-                   std::vector<idxT>& summary,
-                   idxT& summ_s, 
-                   idxT& summ_alph_s,
-                   const idxT& min=0) const {
-      ///- returns a 4-tuple
+   ///template-function for filling the element of the Stack, that holds the input *alph_cont*
+   template<typename alph_cont_T, typename StackEl>
+   void toStack(StackEl& el, 
+                const unsigned& level,
+                std::vector<idxT>& summary,
+                idxT& summ_s, 
+                idxT& summ_alph_s,
+                const idxT& min=0) const {
+      ///- fills the remaining 3 elements of the 4-tuple
       ///- sets *summ_s* and *summ_alph_s* to continue or stop recursion(populating stack)
-      ///1. generate boolean L-S-Type-array
+      ///1. generate bit-packed L-S-Type-array and LMS-bitvector
       ///2. generate mapper to bucket-heads-tails
       ///3. store all lms-indices
       ///4. guess the SA
@@ -188,236 +380,534 @@ private:
       ///6. induce sort S-types
       ///7. make summary, set *summ_s*, set *summ_alph_s* and set indices-array pointing back to summary
       
-//       auto start(std::chrono::steady_clock::now());
-      std::vector<bool> STypes = make_STypes<alph_cont_T>(alph_cont);
-//       std::cout << "\tmaketypes " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start =std::chrono::steady_clock::now();
-      std::vector<idxT> counts(summ_alph_s-min);
-      make_counts(alph_cont, counts, min);
-//       std::cout <<"\tmakecounts "<< std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-      std::vector<idxT> tails;
-      make_buckets(counts, tails, false);
-//       std::cout <<"\tmakebuckets "<< std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-//       std::unordered_map<idxT, idxT> all_lms;
-//       std::vector<idxT> all_lms(alph_cont.size() + 1, 0);
-//       all_lms[alph_cont.size()] = ;
-      std::vector<idxT> guessedSA = guessSortLMS<alph_cont_T>
-                                                (alph_cont, 
-                                                STypes, 
-                                                tails,
-//                                                 all_lms, 
-                                                min);
-//       std::cout<<"\tguesssort " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-      std::vector<idxT> heads;
-      make_buckets(counts, heads, true);
-//       std::cout<<"\tmakebuckets " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-      LInduceSort<alph_cont_T>(guessedSA, alph_cont, STypes, heads, min);
-//       std::cout<<"\tlinduce " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-      SInduceSort<alph_cont_T>(guessedSA, alph_cont, STypes, tails, min);
-//       std::cout<<"\tsinduce" << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-//       start=std::chrono::steady_clock::now();
-      std::vector<idxT> summIdc;
-      summary = summarizeSA<alph_cont_T>
-                           (alph_cont, 
-                           guessedSA, 
-//                            all_lms, 
-                           summ_alph_s,
-                           summIdc,
-                           STypes);
-//       std::cout<<"\tsummarize" << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
-      summ_s = summary.size();
-      return std::make_tuple(alph_cont, STypes, summIdc, counts);
-   }
-   
-   template<typename alph_cont_T>
-   std::vector<bool> make_STypes(std::vector<alph_cont_T> alph_cont) const {
-      ///- takes a vector as argument
-      ///- returns vector of type *bool*. Every index of the input vector at the output-vector, shows if the index is S-Type or not(L-Type).
-      ///- an index i is S-Type, if (argument[i] < argument[i+1]) or 
-      ///((argument[i] = argument[i+1]) and output[i+1] is true)
-      ///- output[argument.size()] always is true, because this index represents the empty suffix
-      ///- output[argument.size()-1] always is false, because the empty(smallest) suffix is always smaller than any other element, that is comparable to it
-      std::vector<bool> STypes(alph_cont.size()+1);
-      STypes[alph_cont.size()] = true;
-      if(alph_cont.size()){
-         STypes[alph_cont.size()-1] = false;
-         for(idxT i = alph_cont.size()-2 ; i != invalid ; --i){
-            if((alph_cont[i] > alph_cont[i+1]) || 
-               ((alph_cont[i] == alph_cont[i+1]) && !(STypes[i+1])))
-               STypes[i] = false;
-            else
-               STypes[i] = true;
-         }
+      const std::vector<alph_cont_T>& alph_cont = text(el);
+      const idxT n = alph_cont.size();
+      LSTypeBits<idxT>& STypes = std::get<1>(el);
+      typedef typename std::tuple_element<3, StackEl>::type bucketT;
+      bucketT& counts = std::get<3>(el);
+      {
+         PhaseTimer t(stats, BuildPhase::Types, level, n);
+         STypes = LSTypeBits<idxT>(alph_cont, ctx);
+         init_counts(counts, summ_alph_s-min);
+         make_counts(alph_cont, counts, min);
+         t.takesBytes(STypes.bytes());
+         t.takes(counts);
       }
-      return STypes;
-   }
-   
-   ///checks if an index points to a LMS-char
-   bool idxIsLMSC(const idxT& i, const std::vector<bool>& STypes) const {
-      ///an index represents a LMS-char, if the index is of S-Type and the preceeding index is of L-Type. 0 is never tested.
-      return STypes[i] && !STypes[i-1];
+      bucketT tails;
+      std::vector<idxT> guessedSA;
+      {
+         PhaseTimer t(stats, BuildPhase::GuessSort, level, n);
+         make_buckets(counts, tails, false);
+         guessedSA = guessSortLMS<alph_cont_T>
+                                 (alph_cont, 
+                                 STypes, 
+                                 tails,
+                                 min);
+         t.takes(tails);
+         t.takes(guessedSA);
+      }
+      bucketT heads;
+      {
+         PhaseTimer t(stats, BuildPhase::LInduce, level, n);
+         make_buckets(counts, heads, true);
+         LInduceSort<alph_cont_T>(guessedSA, alph_cont, STypes, heads, min);
+         t.takes(heads);
+         t.takesBytes(2 * InduceBlockSize * sizeof(idxT));
+      }
+      {
+         PhaseTimer t(stats, BuildPhase::SInduce, level, n);
+         make_buckets(counts, tails, false);
+         SInduceSort<alph_cont_T>(guessedSA, alph_cont, STypes, tails, min);
+         t.takesBytes(2 * InduceBlockSize * sizeof(idxT));
+      }
+      release_counts(tails);
+      release_counts(heads);
+      {
+         PhaseTimer t(stats, BuildPhase::Naming, level, 0);
+         summarizeSA<alph_cont_T>
+                    (alph_cont, 
+                    guessedSA, 
+                    summary,
+                    summ_alph_s,
+                    std::get<2>(el),
+                    STypes);
+         t.setElements(summary.size() - 1);
+         t.takesBytes((n / 2 + 1) * sizeof(idxT));
+         t.takes(summary);
+         t.takes(std::get<2>(el));
+      }
+      giveBuffer(ctx, guessedSA);
+      summ_s = summary.size();
    }
    
    ///function for guessing a (not yet fully)sorted suffix array.
-   template <typename alph_cont_T>
-   std::vector<idxT> guessSortLMS(std::vector<alph_cont_T> alph_cont, 
-                                  const std::vector<bool>& STypes,
-                                  std::vector<idxT> Tails, 
-//                                   std::unordered_map<idxT, idxT>& all_lms,
+   template <typename alph_cont_T, typename bucketT>
+   std::vector<idxT> guessSortLMS(const std::vector<alph_cont_T>& alph_cont, 
+                                  const LSTypeBits<idxT>& STypes,
+                                  bucketT& Tails, 
                                   const idxT& sub) const {
       ///the content of this array is later sorted by *LInduceSort*, *SInduceSort*, *LMSSort* and *LInduceSort*, *SInduceSort* again.
       ///induce-sorts all lms-chars from tails to head.
-      std::vector<idxT> guessedSA(alph_cont.size()+1, invalid);
-//       idxT lms_bef = invalid;
-      idxT i = 1;
-      for( ; i < alph_cont.size() ; ++i){
-         if(idxIsLMSC(i, STypes)){
-            guessedSA[Tails[alph_cont[i] - sub]] = i;
-            --(Tails[alph_cont[i] - sub]);
-//             if(lms_bef != invalid){
-//                all_lms.insert(std::pair<idxT, idxT>(lms_bef, i));
-//             }
-//             lms_bef = i;
-         }
-      }
-      ///modification, lms-chars/substrings are all calculated and stored for later use
-//       all_lms.insert(std::pair<idxT, idxT>(lms_bef, i));
-      /*
-      std::cout << "LMS---\n";
-      for(auto it = all_lms.begin() ; it != all_lms.end() ; ++it){
-         std::cout << it->first << ',' << it->second<<'\n';
-      }
-      std::cout << "------\n";*/
+      std::vector<idxT> guessedSA = takeBuffer<idxT>(ctx, alph_cont.size()+1, invalid);
+      STypes.forEachLMS([&](const idxT& i){
+         const idxT bkt = bucketOf<bucketT>(alph_cont[i], sub);
+         guessedSA[Tails[bkt]] = i;
+         --(Tails[bkt]);
+      });
       guessedSA[0] = alph_cont.size();
       return guessedSA;
    }
    
    ///function for one induce-sort-step of L-Type indices
-   template <typename alph_cont_T>
+   template <typename alph_cont_T, typename bucketT>
    void LInduceSort(std::vector<idxT>& guessedSA,
-                    std::vector<alph_cont_T> alph_cont,
-                    const std::vector<bool>& STypes,
-                    std::vector<idxT>& Heads,
+                    const std::vector<alph_cont_T>& alph_cont,
+                    const LSTypeBits<idxT>& STypes,
+                    bucketT& Heads,
                     const idxT& sub) const {
       ///Use buckets, to bucket-sort L-Type-indices from head to tail
-      for(auto i = guessedSA.cbegin() ; i != guessedSA.cend() ; ++i){
-         if((*i) != invalid){
-            idxT j = (*i) - 1;
-            if(j != invalid && !STypes[j]){
-               guessedSA[Heads[alph_cont[j] - sub]] = j;
-               ++(Heads[alph_cont[j] - sub]);
+      ///
+      ///The array is scanned in blocks, with *read_ahead* the buckets of the preceding indices of a block are read ahead by *readAhead*.
+      ///Entries written into the block after reading ahead differ from the read index and are looked up while scanning.
+      std::vector<idxT> read_idx = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      std::vector<idxT> read_bkt = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      for(idxT b = 0 ; b < guessedSA.size() ; b += InduceBlockSize){
+         const idxT e = std::min<idxT>(guessedSA.size(), b + InduceBlockSize);
+         if(read_ahead)
+            readAhead<alph_cont_T, bucketT>(guessedSA, alph_cont, STypes, b, e, false, sub, read_idx, read_bkt);
+         for(idxT i = b ; i < e ; ++i){
+            const idxT idx = guessedSA[i];
+            const idxT bkt = read_ahead && idx == read_idx[i - b] ? read_bkt[i - b] 
+                                                    : precedingBucket<alph_cont_T, bucketT>(alph_cont, STypes, idx, false, sub);
+            if(bkt != invalid){
+               guessedSA[Heads[bkt]] = idx - 1;
+               ++(Heads[bkt]);
             }
          }
       }
+      giveBuffer(ctx, read_idx);
+      giveBuffer(ctx, read_bkt);
    }
    
    ///function for one induce-sort-step of S-Type indices
-   template <typename alph_cont_T>
+   template <typename alph_cont_T, typename bucketT>
    void SInduceSort(std::vector<idxT>& guessedSA,
-                    std::vector<alph_cont_T> alph_cont,
-                    const std::vector<bool>& STypes,
-                    std::vector<idxT>& Tails,
+                    const std::vector<alph_cont_T>& alph_cont,
+                    const LSTypeBits<idxT>& STypes,
+                    bucketT& Tails,
                     const idxT& sub) const {
       ///Use buckets, to bucket-sort S-Type-indices from tail to head
-      for(auto i = guessedSA.crbegin() ; i != guessedSA.crend() ; ++i){
-         if((*i) != invalid){
-            idxT j = (*i) - 1;
-            if(j != invalid && STypes[j]){
-               guessedSA[Tails[alph_cont[j] - sub]] = j;
-               --(Tails[alph_cont[j] - sub]);
+      ///
+      ///Same blocks as *LInduceSort* from the last to the first block,
+      ///S-Type-indices can overwrite entries of the current block, those are looked up while scanning.
+      std::vector<idxT> read_idx = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      std::vector<idxT> read_bkt = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      for(idxT e = guessedSA.size() ; e ; ){
+         const idxT b = e > InduceBlockSize ? e - InduceBlockSize : 0;
+         if(read_ahead)
+            readAhead<alph_cont_T, bucketT>(guessedSA, alph_cont, STypes, b, e, true, sub, read_idx, read_bkt);
+         for(idxT i = e - 1 ; i != idxT(b - 1) ; --i){
+            const idxT idx = guessedSA[i];
+            const idxT bkt = read_ahead && idx == read_idx[i - b] ? read_bkt[i - b] 
+                                                    : precedingBucket<alph_cont_T, bucketT>(alph_cont, STypes, idx, true, sub);
+            if(bkt != invalid){
+               guessedSA[Tails[bkt]] = idx - 1;
+               --(Tails[bkt]);
+            }
+         }
+         e = b;
+      }
+      giveBuffer(ctx, read_idx);
+      giveBuffer(ctx, read_bkt);
+   }
+   
+   ///sets the lcp-value of every sorted LMS-suffix in *idc* (the result of *LMSSort*) at its position: 
+   ///the longest common prefix with the preceding LMS-suffix, 0 for the smallest one
+   template <typename alph_cont_T>
+   void LMSLCP(const std::vector<alph_cont_T>& alph_cont,
+               const std::vector<idxT>& idc,
+               const std::vector<idxT>& summarySA,
+               const std::vector<idxT>& summIdc,
+               std::vector<idxT>& lcp) const {
+      ///The LMS-suffixes are the suffixes of the summary, so their lcp in LMS-substrings follows from the algorithm of Kasai et al.
+      ///over the summary in text-order, the predecessors of the suffixes of the summary (Phi) replace its inverse suffix-array.
+      ///The summary is already released, so two LMS-substrings are equal, if their characters and lengths are (as in *summarizeSA*).
+      ///The lcp in characters is the length of the equal LMS-substrings and the common prefix of the first different ones.
+      ///
+      ///*lcp* is the workspace, no LMS-suffix is in front of the other half of the input:
+      ///Phi and the lcp-values in text-order are stored in lcp[m, 2m), they are gathered in sorted order into lcp[0, m)
+      ///and moved to the positions of the LMS-suffixes from the last to the first one.
+      const idxT n = alph_cont.size();
+      const idxT m = summarySA.size() - 2;
+      lcp.resize(n + 1);
+      idxT* phi = lcp.data() + m;
+      ///summarySA[1] is the empty suffix of the summary, it is the predecessor of the smallest LMS-suffix
+      for(idxT k = 2 ; k < summarySA.size() ; ++k){
+         phi[summarySA[k]] = k == 2 ? invalid : summarySA[k - 1];
+      }
+      ///the predecessors are read *PrefetchDistance* LMS-suffixes ahead: their positions twice as far, their characters once
+      for(idxT j = 0, l = 0 ; j < m ; ++j){
+         if(j + 2 * PrefetchDistance < m && phi[j + 2 * PrefetchDistance] != invalid)
+            __builtin_prefetch(&summIdc[std::min<idxT>(m, phi[j + 2 * PrefetchDistance] + l)]);
+         if(j + PrefetchDistance < m && phi[j + PrefetchDistance] != invalid)
+            __builtin_prefetch(alph_cont.data() + summIdc[std::min<idxT>(m, phi[j + PrefetchDistance] + l)]);
+         const idxT q = phi[j];
+         if(q == invalid){
+            phi[j] = l = 0;
+            continue;
+         }
+         while(j + l < m && q + l < m && equalLMS(alph_cont, summIdc, j + l, q + l)){
+            ++l;
+         }
+         const idxT equal = summIdc[j + l] - summIdc[j];
+         phi[j] = equal + commonPrefix(alph_cont, summIdc[j] + equal, summIdc[q] + equal);
+         if(l) --l;
+      }
+      for(idxT k = 2 ; k < summarySA.size() ; ++k){
+         if(k + PrefetchDistance < summarySA.size())
+            __builtin_prefetch(&phi[summarySA[k + PrefetchDistance]]);
+         lcp[k - 2] = phi[summarySA[k]];
+      }
+      ///the LMS-suffix of rank k is at least at position k - 1, behind the lcp-values of the smaller ones
+      for(idxT i = n, k = m ; k ; --i){
+         if(idc[i] != invalid)
+            lcp[i] = lcp[--k];
+      }
+      lcp[0] = 0;
+   }
+   
+   ///checks if the LMS-substrings *x* and *y* (indices into *summIdc*) are equal, LMS-substrings, that end at the end of the input, are unique
+   template <typename alph_cont_T>
+   bool equalLMS(const std::vector<alph_cont_T>& alph_cont,
+                 const std::vector<idxT>& summIdc,
+                 const idxT& x,
+                 const idxT& y) const {
+      const idxT n = alph_cont.size();
+      const idxT x_end = summIdc[x + 1], y_end = summIdc[y + 1];
+      return x_end != n && y_end != n && 
+             x_end - summIdc[x] == y_end - summIdc[y] &&
+             std::equal(alph_cont.begin() + summIdc[x], alph_cont.begin() + x_end + 1, alph_cont.begin() + summIdc[y]);
+   }
+   
+   ///longest common prefix of the suffixes at *a* and *b*
+   template <typename alph_cont_T>
+   static idxT commonPrefix(const std::vector<alph_cont_T>& alph_cont, idxT a, idxT b){
+      const idxT start = a;
+      while(a < alph_cont.size() && b < alph_cont.size() && alph_cont[a] == alph_cont[b]){
+         ++a;
+         ++b;
+      }
+      return a - start;
+   }
+   
+   ///pushes position *i* to the positions of the suffix-minima of the lcp-values, the lcp-values of the stack strictly increase
+   void pushMinimum(std::vector<idxT>& minima, const std::vector<idxT>& lcp, const idxT& i) const {
+      while(minima.size() && lcp[minima.back()] >= lcp[i]){
+         minima.pop_back();
+      }
+      minima.push_back(i);
+   }
+   
+   ///keeps only the entries of *minima*, that are the first one behind the position *last* of a bucket (*behind*),
+   ///the others are never the minimum of a requested range: the positions of *last* only move to the newest entry,
+   ///and an entry behind another one in the same range is popped before it. So at most one entry per bucket is kept.
+   template<typename bucketT, typename Behind>
+   void compactMinima(std::vector<idxT>& minima, 
+                      const bucketT& last, 
+                      std::vector<idxT>& keep, 
+                      const Behind& behind) const {
+      keep.clear();
+      for(size_t c = 0 ; c < last.size() ; ++c){
+         if(last[c] == invalid)
+            continue;
+         const idxT from = last[c];
+         const size_t k = std::partition_point(minima.begin(), minima.end(), [&](const idxT& p){ return !behind(p, from); }) - minima.begin();
+         if(k < minima.size())
+            keep.push_back(k);
+      }
+      std::sort(keep.begin(), keep.end());
+      keep.erase(std::unique(keep.begin(), keep.end()), keep.end());
+      for(size_t k = 0 ; k < keep.size() ; ++k)
+         minima[k] = minima[keep[k]];
+      minima.resize(keep.size());
+   }
+   
+   ///*LInduceSort* with lcp-values, *lcp* holds the values of the LMS-suffixes (*LMSLCP*)
+   template <typename alph_cont_T, typename bucketT>
+   void LInduceSortLCP(std::vector<idxT>& guessedSA,
+                       const std::vector<alph_cont_T>& alph_cont,
+                       const LSTypeBits<idxT>& STypes,
+                       bucketT& Heads,
+                       const idxT& sub,
+                       std::vector<idxT>& lcp) const {
+      ///lcp[i] is the lcp of the suffixes at i and at the occupied position in front of i.
+      ///Two L-Types, that are induced into the same bucket by the suffixes at i' < i, 
+      ///have the lcp 1 + the minimum of lcp(i', i], taken from the stack of the suffix-minima of the scanned lcp-values.
+      ///The bucket-head of every L-Type-suffix is scanned, before it is induced,
+      ///so *last* holds the scanned position, that induced the previous L-Type into a bucket (*invalid* for none).
+      ///
+      ///When the scan reaches the first LMS-suffix behind the L-Types of its bucket, the L-Types of the bucket are complete,
+      ///their lcp is compared directly: both suffixes start with the run of the bucket's character, 
+      ///so the comparisons of all buckets sum up to the input's length at most.
+      ///The blocks and the read-ahead are the same as in *LInduceSort*.
+      ///The stack is compacted to one entry per bucket (*compactMinima*), when it holds *MinimaPerBucket* entries per bucket,
+      ///so it stays in O(alphabet-size) words also on repetitive inputs.
+      bucketT last;
+      init_counts(last, Heads.size());
+      std::fill(last.begin(), last.end(), invalid);
+      const size_t max_minima = MinimaPerBucket * last.size() + MinimaPerBucket;
+      std::vector<idxT> minima = takeBuffer<idxT>(ctx, max_minima + 1);
+      std::vector<idxT> keep = takeBuffer<idxT>(ctx, last.size());
+      minima.clear();
+      std::vector<idxT> read_idx = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      std::vector<idxT> read_bkt = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      ///the entry in front of the scanned one is empty or a L-Type
+      bool behind_L = false;
+      for(idxT b = 0 ; b < guessedSA.size() ; b += InduceBlockSize){
+         const idxT e = std::min<idxT>(guessedSA.size(), b + InduceBlockSize);
+         if(read_ahead)
+            readAhead<alph_cont_T, bucketT>(guessedSA, alph_cont, STypes, b, e, false, sub, read_idx, read_bkt);
+         for(idxT i = b ; i < e ; ++i){
+            const idxT idx = guessedSA[i];
+            if(idx == invalid){
+               behind_L = true;
+               continue;
+            }
+            const bool S = STypes.isS(idx);
+            if(S && behind_L){
+               const idxT c = bucketOf<bucketT>(alph_cont[idx], sub);
+               if(last[c] != invalid)
+                  lcp[i] = commonPrefix(alph_cont, guessedSA[Heads[c] - 1], idx);
+            }
+            behind_L = !S;
+            pushMinimum(minima, lcp, i);
+            if(minima.size() > max_minima)
+               compactMinima(minima, last, keep, [](const idxT& p, const idxT& from){ return p > from; });
+            const idxT bkt = read_ahead && idx == read_idx[i - b] ? read_bkt[i - b] 
+                                                    : precedingBucket<alph_cont_T, bucketT>(alph_cont, STypes, idx, false, sub);
+            if(bkt != invalid){
+               const idxT pos = Heads[bkt];
+               guessedSA[pos] = idx - 1;
+               if(last[bkt] == invalid){
+                  lcp[pos] = 0;
+               }
+               else{
+                  const idxT from = last[bkt];
+                  lcp[pos] = 1 + lcp[*std::partition_point(minima.begin(), minima.end(), [&](const idxT& p){ return p <= from; })];
+               }
+               last[bkt] = i;
+               ++(Heads[bkt]);
             }
          }
       }
+      giveBuffer(ctx, read_idx);
+      giveBuffer(ctx, read_bkt);
+      giveBuffer(ctx, minima);
+      giveBuffer(ctx, keep);
+      release_counts(last);
+   }
+   
+   ///*SInduceSort* with lcp-values, *lcp* holds the values of the L-Types (*LInduceSortLCP*), *Heads* are the bucket-heads
+   template <typename alph_cont_T, typename bucketT>
+   void SInduceSortLCP(std::vector<idxT>& guessedSA,
+                       const std::vector<alph_cont_T>& alph_cont,
+                       const LSTypeBits<idxT>& STypes,
+                       bucketT& Tails,
+                       const bucketT& Heads,
+                       const idxT& sub,
+                       std::vector<idxT>& lcp) const {
+      ///Mirror of *LInduceSortLCP* from the last to the first position: inducing an S-Type in front of the previous S-Type of its bucket
+      ///sets the lcp-value of the previous one. All S-Types (also the LMS-suffixes) are induced again.
+      ///The scan follows the bucket of the scanned position (*cur*), when the position is the bucket-tail + 1, 
+      ///it is the first S-Type of its bucket, its lcp with the last L-Type in front of it is compared directly.
+      bucketT last;
+      init_counts(last, Tails.size());
+      std::fill(last.begin(), last.end(), invalid);
+      const size_t max_minima = MinimaPerBucket * last.size() + MinimaPerBucket;
+      std::vector<idxT> minima = takeBuffer<idxT>(ctx, max_minima + 1);
+      std::vector<idxT> keep = takeBuffer<idxT>(ctx, last.size());
+      minima.clear();
+      std::vector<idxT> read_idx = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      std::vector<idxT> read_bkt = takeBuffer<idxT>(ctx, read_ahead ? InduceBlockSize : 0);
+      idxT cur = Heads.size() - 1;
+      for(idxT e = guessedSA.size() ; e ; ){
+         const idxT b = e > InduceBlockSize ? e - InduceBlockSize : 0;
+         if(read_ahead)
+            readAhead<alph_cont_T, bucketT>(guessedSA, alph_cont, STypes, b, e, true, sub, read_idx, read_bkt);
+         for(idxT i = e - 1 ; i != idxT(b - 1) ; --i){
+            while(cur && i < Heads[cur]){
+               --cur;
+            }
+            const idxT idx = guessedSA[i];
+            const idxT bkt = read_ahead && idx == read_idx[i - b] ? read_bkt[i - b] 
+                                                    : precedingBucket<alph_cont_T, bucketT>(alph_cont, STypes, idx, true, sub);
+            if(bkt != invalid){
+               const idxT pos = Tails[bkt];
+               guessedSA[pos] = idx - 1;
+               if(last[bkt] != invalid){
+                  const idxT from = last[bkt];
+                  lcp[pos + 1] = 1 + lcp[*std::partition_point(minima.begin(), minima.end(), [&](const idxT& p){ return p > from; })];
+               }
+               last[bkt] = i;
+               --(Tails[bkt]);
+            }
+            if(i && Tails[cur] + 1 == i)
+               lcp[i] = commonPrefix(alph_cont, guessedSA[i - 1], idx);
+            pushMinimum(minima, lcp, i);
+            if(minima.size() > max_minima)
+               compactMinima(minima, last, keep, [](const idxT& p, const idxT& from){ return p <= from; });
+         }
+         e = b;
+      }
+      giveBuffer(ctx, read_idx);
+      giveBuffer(ctx, read_bkt);
+      giveBuffer(ctx, minima);
+      giveBuffer(ctx, keep);
+      release_counts(last);
+   }
+   
+   ///returns the bucket of the index in front of *idx*, if it is of the requested type, otherwise *invalid*
+   template <typename alph_cont_T, typename bucketT>
+   idxT precedingBucket(const std::vector<alph_cont_T>& alph_cont,
+                        const LSTypeBits<idxT>& STypes,
+                        const idxT& idx,
+                        const bool& S,
+                        const idxT& sub) const {
+      if(idx == invalid || !idx || STypes.isS(idx - 1) != S)
+         return invalid;
+      return bucketOf<bucketT>(alph_cont[idx - 1], sub);
+   }
+   
+   ///reads the entries of guessedSA[b, e) and the buckets of their preceding indices, 
+   ///the reads into *alph_cont* and *STypes* do not depend on each other and are prefetched *PrefetchDistance* entries ahead, so their cache-misses overlap
+   template <typename alph_cont_T, typename bucketT>
+   void readAhead(const std::vector<idxT>& guessedSA,
+                  const std::vector<alph_cont_T>& alph_cont,
+                  const LSTypeBits<idxT>& STypes,
+                  const idxT& b,
+                  const idxT& e,
+                  const bool& S,
+                  const idxT& sub,
+                  std::vector<idxT>& read_idx,
+                  std::vector<idxT>& read_bkt) const {
+      for(idxT i = b ; i < e ; ++i){
+         if(i + PrefetchDistance < e){
+            const idxT ahead = guessedSA[i + PrefetchDistance];
+            if(ahead != invalid && ahead){
+               __builtin_prefetch(&alph_cont[ahead - 1]);
+               STypes.prefetch(ahead - 1);
+            }
+         }
+         read_idx[i - b] = guessedSA[i];
+         read_bkt[i - b] = precedingBucket<alph_cont_T, bucketT>(alph_cont, STypes, guessedSA[i], S, sub);
+      }
    }
 
    ///function to generate a shorter representation of the input with their corresponding index
    template <typename alph_cont_T>
-   std::vector<idxT> summarizeSA(std::vector<alph_cont_T> alph_cont,
-                                 const std::vector<idxT>& guessedSA,
-//                                  const std::unordered_map<idxT, idxT>& all_lms,
-                                 idxT& summ_alph_s,
-                                 std::vector<idxT>& summIdc, 
-                                 const std::vector<bool>& STypes) const {
+   void summarizeSA(const std::vector<alph_cont_T>& alph_cont,
+                    const std::vector<idxT>& guessedSA,
+                    std::vector<idxT>& summ,
+                    idxT& summ_alph_s,
+                    std::vector<idxT>& summIdc, 
+                    const LSTypeBits<idxT>& STypes) const {
+      ///- *summ*, the shorter representation is set
       ///- *summ_alph_s*, the alphabet-size of the shorter representation is set
       ///- *summIdc*, indices pointing back are set
-      ///- if *summ_alph_s* differs from the size of the returned array, the recursion(population of the Stack) continues
+      ///- if *summ_alph_s* differs from the size of *summ*, the recursion(population of the Stack) continues
       ///- compares all lms-substrings for uniqueness, depending on those, the summary is generated
       ///- in worst case summary is half the size of input
+      ///
+      ///No index-sized lookup-table is needed: 
+      ///the end of a lms-substring is the next set bit in the LMS-bitvector of *STypes*, 
+      ///the names are stored at index/2 of their lms-char, because lms-chars are never neighbours
+      const idxT n = alph_cont.size();
+      std::vector<idxT> names = takeBuffer<idxT>(ctx, n / 2 + 1, invalid);
       
-      std::pair<idxT, idxT> lms_bef(guessedSA[0], guessedSA[0]);
-      std::vector<idxT> lms(alph_cont.size() + 1, invalid);
-      
+      ///the empty suffix (guessedSA[0]) is the only lms-substring ending at n and gets name 0
       idxT cur_name = 0;
-      lms[guessedSA[0]] = cur_name;
-      
-      std::vector<idxT> all_lms(alph_cont.size()+1, 0);
-      idxT alllms_bef = alph_cont.size();
-      for(idxT i = alph_cont.size() - 1 ; i ; --i){
-         if(idxIsLMSC(i, STypes)){
-            all_lms[i] = alllms_bef;
-            alllms_bef = i;
-         }
-      }
-      
-      idxT lms_bef_fir = guessedSA[0], lms_bef_sec = guessedSA[0];
-      
-      std::vector<idxT> summ;
-      summ.reserve(all_lms.size());
-      summIdc.reserve(all_lms.size());
+      idxT lms_bef_fir = n, lms_bef_sec = n;
+      idxT lms_count = 0;
       
       for(idxT i = 1 ; i < guessedSA.size() ; ++i){
-//          auto lms_pair = all_lms.find(guessedSA[i]);
          idxT lms_i = guessedSA[i];
-         if(all_lms[guessedSA[i]]){
-            if(!std::equal(alph_cont.begin() + lms_bef_fir, 
-                           alph_cont.begin() + lms_bef_sec, 
-                           alph_cont.begin() + lms_i, 
-                           alph_cont.begin() + all_lms[lms_i])){
+         if(STypes.isLMS(lms_i)){
+            idxT lms_end = STypes.nextLMS(lms_i);
+            if(lms_end == n || lms_bef_sec == n ||
+               lms_end - lms_i != lms_bef_sec - lms_bef_fir ||
+               !std::equal(alph_cont.begin() + lms_i, 
+                           alph_cont.begin() + lms_end + 1, 
+                           alph_cont.begin() + lms_bef_fir)){
                ++cur_name;
             }
-            lms[guessedSA[i]] = cur_name;
+            names[lms_i >> 1] = cur_name;
             lms_bef_fir = lms_i;
-            lms_bef_sec = all_lms[lms_i];
-         }
-      }
-
-      for(idxT i = 0 ; i < lms.size() ; ++i){
-         if(lms[i] != invalid){
-            summ.push_back(lms[i]);
-            summIdc.push_back(i);
+            lms_bef_sec = lms_end;
+            ++lms_count;
          }
       }
+      
+      summ = takeBuffer<idxT>(ctx, lms_count + 1);
+      summIdc = takeBuffer<idxT>(ctx, lms_count + 1);
+      idxT k = 0;
+      STypes.forEachLMS([&](const idxT& i){
+         summ[k] = names[i >> 1];
+         summIdc[k] = i;
+         ++k;
+      });
+      summ[k] = 0;
+      summIdc[k] = n;
+      giveBuffer(ctx, names);
       summ_alph_s = cur_name+1;
-      return summ;
    }
    
    ///function for induce sorting lms-indices into the correct position, after population of stack ended
-   template <typename alph_cont_T>
-   std::vector<idxT> LMSSort(std::vector<alph_cont_T> alph_cont, 
-                             std::vector<idxT> Tails, 
-                             const std::vector<bool>& STypes, 
+   template <typename alph_cont_T, typename bucketT>
+   std::vector<idxT> LMSSort(const std::vector<alph_cont_T>& alph_cont, 
+                             bucketT& Tails, 
+                             const LSTypeBits<idxT>& STypes, 
                              const std::vector<idxT>& summarySA, 
                              const std::vector<idxT>& summIdc,
                              const idxT& sub) const {
       
-      std::vector<idxT> suffIdc(alph_cont.size()+1, invalid);
+      std::vector<idxT> suffIdc = takeBuffer<idxT>(ctx, alph_cont.size()+1, invalid);
       /// Use the summary and the previously stored indices and buckets, to bucket-sort indices from tail to head
       for(idxT i = summarySA.size()-1 ; i > 1 ; --i){
          idxT idx = summIdc[summarySA[i]];
-         suffIdc[Tails[alph_cont[idx] - sub]] = idx;
-         --(Tails[alph_cont[idx] - sub]);
+         const idxT bkt = bucketOf<bucketT>(alph_cont[idx], sub);
+         suffIdc[Tails[bkt]] = idx;
+         --(Tails[bkt]);
       }
       /// Sets first element of the array as the empty(smallest) suffix of the previous summary/input-array
       suffIdc[0] = alph_cont.size();
       return suffIdc;
    }
    
+   ///count of suffix-array-entries, whose preceding buckets are read ahead together in the induce-sort-steps
+   static const size_t InduceBlockSize = 1 << 12;
+   ///distance in suffix-array-entries, at which the preceding chars and types are prefetched while reading ahead
+   static const size_t PrefetchDistance = 32;
+   ///entries per bucket, at which the stack of the suffix-minima of the induced lcp-values is compacted
+   static const size_t MinimaPerBucket = 4;
+   
    ///invalid index
    const idxT invalid;
    const idxT subtract;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
+   ///statistics of the phases, *nullptr* records nothing
+   BuildStats* const stats;
+   const BuildCheckpoint* const checkpoint;
+   ///read the buckets of the preceding indices of a block ahead in the induce-sort-steps (*readAhead*), switched on by ''-ra''
+   const bool read_ahead;
 };
+
+///definitions of the constants, that are bound to references (e.g. by the operators of *uint40*)
+template<typename alph, typename idxT>
+const size_t SuffixArrayInducedSorting<alph,idxT>::ByteSigma;
+template<typename alph, typename idxT>
+const size_t SuffixArrayInducedSorting<alph,idxT>::InduceBlockSize;
+template<typename alph, typename idxT>
+const size_t SuffixArrayInducedSorting<alph,idxT>::PrefetchDistance;
+template<typename alph, typename idxT>
+const size_t SuffixArrayInducedSorting<alph,idxT>::MinimaPerBucket;
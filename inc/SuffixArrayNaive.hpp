@@ -5,10 +5,15 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
 
 #include "typeChecks.hpp"
+#include "BuildContext.hpp"
 
-#include "tbb/parallel_sort.h"
+#include "tbb/task_group.h"
 
 #include "tbb/task_scheduler_init.h"
 
@@ -16,23 +21,26 @@
 ///Template-Function-Object for creating a suffix-array
 template<typename alph=char, typename idxT=size_t>
 class SuffixArrayNaive{
-///This is the naive version for creating the array,
-///there is a serial version (using **STL** *std::sort*) 
-///and a parallel version (using **TBB** *tbb::parallel_sort*)
+///This is the naive version for creating the array, the suffixes are sorted as strings
+///by multikey-quicksort, there is a serial version 
+///and a parallel version (using **TBB** *tbb::task_group*)
 ///
 ///- typename *alph* 
-///> is required for using Comp, which uses *std::lexicographical_compare*
-///>
-///> pointers of type *alph\** are stored within Comp.
+///> type of elements of the input-vector, *CharsPerKey* of them are packed into one key of 8 bytes
 ///
 ///- typename idxT
 ///> determines type of indices, stored in the final suffix-array
-private:
-struct Comp;
+///
+///The keys of a group of suffixes, that share their first *d* characters, are read once and cached,
+///the group is split by the cached keys and only the suffixes with equal keys read the next *CharsPerKey* characters.
+///A common prefix is never compared twice, if all keys of a group are equal, the common prefix of the group is skipped at once.
+///
+///With a *BuildContext* the suffix-array and the cached keys are taken from its pools.
 public:
-   ///the constructor takes one optional boolean argument, if true, parallel-version is used, if false, serial version is used
-   SuffixArrayNaive(const bool& p=true)
-   : p_mode(p)
+   ///the constructor takes one optional boolean argument, if true, parallel-version is used, if false, serial version is used,
+   ///and the optional context, whose buffers are used
+   SuffixArrayNaive(const bool& p=true, BuildContext* context=nullptr)
+   : p_mode(p), ctx(context)
    {}
    ///- *operator()*, takes a *std::vector* of type *alph* as argument
    ///- returns a *std::vector* of type *idxT* (final suffix-array)
@@ -48,64 +56,200 @@ public:
       return SA;
    }
    
+   ///sorts the suffixes of the input [*begin*, *end*), that start at the positions *p*[0, k), 
+   ///the keys of the suffixes are cached in 8 more bytes per suffix
+   void sortSuffixes(const alph* begin, 
+                     const alph* end, 
+                     idxT* p, 
+                     const idxT& k) const {
+      if(k < 2)
+         return;
+      std::vector<uint64_t> keys = takeBuffer<uint64_t>(ctx, k);
+      tbb::task_scheduler_init tbb_init(p_mode ? tbb::task_scheduler_init::automatic : 1);
+      
+      multikeySort(begin, end-begin, p, &keys[0], k, 0, false);
+      giveBuffer(ctx, keys);
+   }
+   
 private:
+   ///count of characters packed into one key
+   static const unsigned CharsPerKey = sizeof(alph) < 8 ? 8 / sizeof(alph) : 1;
+   ///bits of one character in a key
+   static const unsigned CharBits = 8 * sizeof(alph);
+   ///groups smaller than this are sorted by insertion-sort
+   static const size_t SmallGroup = 16;
+   ///groups bigger than this are sorted as own tasks in the parallel version
+   static const size_t ParallelGroup = 1 << 13;
+
    ///- *make_SA* takes pointers to the beginning and the end of the input-vector as arguments
    ///- returns a *std::vector* of type *idxT* (final suffix-array)
    std::vector<idxT> make_SA(const alph* begin, 
                               const alph* end) const {
       ///1. initialize suffix-array
-      std::vector<idxT> indices;
-      indices.reserve(end-begin+1);
+      std::vector<idxT> indices = takeBuffer<idxT>(ctx, end-begin+1);
       
-      indices.push_back(end-begin);
+      indices[0] = end-begin;
       
-      for(idxT i = 0 ; i < end-begin ; ++i){
-         indices.push_back(i);
+      for(idxT i = 0 ; i < idxT(end-begin) ; ++i){
+         indices[i+1] = i;
       }
-//       indices.resize(end-begin+1, 0);
-      indices[0] = end-begin;
-//       std::iota(indices.begin()+1, indices.end(), 0);
-      ///2. sort suffix-array with Comp
-      if(p_mode){
-         tbb::task_scheduler_init tbb_init;
-         
-         tbb::parallel_sort(indices.begin()+1, 
-                           indices.end(), 
-                           Comp(begin, end));
+      ///2. sort suffix-array by multikey-quicksort
+      sortSuffixes(begin, end, &indices[0] + 1, end-begin);
+      ///3. Sets first element of the suffix-array as the empty(smallest) suffix
+      return indices;
+   }
+   
+   ///maps a character to an unsigned code of the same order
+   static uint64_t charCode(const alph& c){
+      typedef typename std::make_unsigned<alph>::type ualph;
+      const ualph flip = std::is_signed<alph>::value ? ualph(ualph(1) << (CharBits - 1)) : ualph(0);
+      return uint64_t(ualph(ualph(c) ^ flip));
+   }
+   
+   ///key of the characters [i, i + *CharsPerKey*) of the input *T* of length *n*, characters behind the end are 0
+   static uint64_t key(const alph* T, const idxT& n, const idxT& i){
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      ///8 single-byte characters are loaded at once, the byte-swap puts the first character into the highest byte
+      if(sizeof(alph) == 1 && i + 8 <= n){
+         uint64_t k;
+         std::memcpy(&k, T + i, 8);
+         return __builtin_bswap64(k) ^ (std::is_signed<alph>::value ? uint64_t(0x8080808080808080) : 0);
+      }
+#endif
+      uint64_t k = i < n ? charCode(T[i]) : 0;
+      for(idxT j = i + 1 ; j < i + CharsPerKey ; ++j){
+         k = (k << (CharBits % 64)) | (j < n ? charCode(T[j]) : 0);
+      }
+      return k;
+   }
+   
+   ///sorts the suffixes *p*[0, k) of the input *T* of length *n*, that share their first *d* characters,
+   ///*c*[0, k) holds their keys at depth *d*, if *cached* is true
+   void multikeySort(const alph* T, 
+                     const idxT& n, 
+                     idxT* p, 
+                     uint64_t* c, 
+                     idxT k, 
+                     idxT d, 
+                     bool cached) const {
+      tbb::task_group tasks;
+      while(k > 1){
+         if(k < SmallGroup){
+            insertionSort(T, n, p, k, d);
+            break;
+         }
+         ///1. read the keys of this depth once, if they are all equal, the whole common prefix of the group is skipped
+         if(!cached){
+            bool equal = true;
+            for(idxT j = 0 ; j < k ; ++j){
+               c[j] = key(T, n, p[j] + d);
+               equal = equal && c[j] == c[0];
+            }
+            if(equal){
+               idxT common = n - std::max(p[0], *std::max_element(p + 1, p + k)) - d;
+               for(idxT j = 1 ; j < k && common >= CharsPerKey ; ++j){
+                  common = commonPrefix(T, p[0] + d, p[j] + d, common);
+               }
+               if(common >= CharsPerKey){
+                  d += common;
+                  continue;
+               }
+            }
+         }
+         ///2. split into keys *c*[0, lt) < v, *c*[lt, gt) == v, *c*[gt, k) > v
+         const uint64_t x = c[0], y = c[k >> 1], z = c[k - 1];
+         const uint64_t v = x < y ? (y < z ? y : (x < z ? z : x))
+                                  : (y > z ? y : (x > z ? z : x));
+         idxT lt = 0, i = 0, gt = k;
+         while(i < gt){
+            if(c[i] < v)
+               swapEntries(p, c, lt++, i++);
+            else if(c[i] > v)
+               swapEntries(p, c, i, --gt);
+            else
+               ++i;
+         }
+         ///3. the smaller and bigger keys are sorted at the same depth, big parts as own tasks in the parallel version
+         sortPart(T, n, p, c, lt, d, tasks);
+         sortPart(T, n, p + gt, c + gt, k - gt, d, tasks);
+         ///4. the equal keys continue at the next depth, suffixes ending inside the key come first, shortest first
+         p += lt;
+         c += lt;
+         k = gt - lt;
+         idxT ended = 0;
+         for(idxT j = 0 ; j < k ; ++j){
+            if(n - (p[j] + d) < CharsPerKey)
+               swapEntries(p, c, ended++, j);
+         }
+         std::sort(p, p + ended, std::greater<idxT>());
+         p += ended;
+         c += ended;
+         k -= ended;
+         d += CharsPerKey;
+         cached = false;
+      }
+      tasks.wait();
+   }
+   
+   ///sorts the suffixes *p*[0, k) with cached keys at depth *d*, as own task, if the parallel version is used and the part is big
+   void sortPart(const alph* T, 
+                 const idxT& n, 
+                 idxT* p, 
+                 uint64_t* c, 
+                 const idxT& k, 
+                 const idxT& d, 
+                 tbb::task_group& tasks) const {
+      if(p_mode && k > ParallelGroup){
+         tasks.run([=](){ multikeySort(T, n, p, c, k, d, true); });
       }
       else{
-         std::sort(indices.begin()+1, 
-                  indices.end(), 
-                  Comp(begin, end));   
+         multikeySort(T, n, p, c, k, d, true);
       }
-      ///3. Sets first element of the suffix-array as the empty(smallest) suffix
-      return indices;
    }
    
-   ///Compare fuction-object
-   struct Comp{
-   public:
-      ///constructor takes pointers to the beginning and the end of the input-vector as arguments and stores them in *beg_corp* and *end_corp*
-      Comp(const alph* beg, const alph* end){
-         beg_corp = beg;
-         end_corp = end;
+   ///length of the common prefix of the suffixes *a* and *b* of the input *T*, at most *limit*
+   static idxT commonPrefix(const alph* T, const idxT& a, const idxT& b, const idxT& limit){
+      idxT l = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      ///single-byte characters are compared 8 at a time, the first differing byte is the lowest set byte of the xor
+      if(sizeof(alph) == 1){
+         for( ; l + 8 <= limit ; l += 8){
+            uint64_t x, y;
+            std::memcpy(&x, T + a + l, 8);
+            std::memcpy(&y, T + b + l, 8);
+            if(x != y)
+               return l + (__builtin_ctzll(x ^ y) >> 3);
+         }
       }
-      ///- *operator()*, takes indices of type *idxT* as arguments
-      ///- returns true, if suffix starting at *beg_corp* + idx1 is smaller than suffix starting at *beg_corp* + idx2, using *std::lexicographical_compare*
-      bool operator()(const idxT& idx1, 
-                      const idxT& idx2) const {
-         return std::lexicographical_compare(beg_corp+idx1, end_corp,
-                                             beg_corp+idx2, end_corp);
+#endif
+      while(l < limit && T[a + l] == T[b + l])
+         ++l;
+      return l;
+   }
+   
+   ///insertion-sort of the suffixes *p*[0, k), that share their first *d* characters
+   void insertionSort(const alph* T, 
+                      const idxT& n, 
+                      idxT* p, 
+                      const idxT& k, 
+                      const idxT& d) const {
+      for(idxT i = 1 ; i < k ; ++i){
+         for(idxT j = i ; j > 0 && std::lexicographical_compare(T + p[j] + d, T + n, 
+                                                                T + p[j - 1] + d, T + n) ; --j){
+            std::swap(p[j - 1], p[j]);
+         }
       }
-   private:
-      ///beginning of input-vector
-      const alph* beg_corp;
-      ///end of input-vector
-      const alph* end_corp;
-   };
+   }
+   
+   static void swapEntries(idxT* p, uint64_t* c, const idxT& a, const idxT& b){
+      std::swap(p[a], p[b]);
+      std::swap(c[a], c[b]);
+   }
    
    ///Parallel mode off or on
    const bool p_mode;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
 };
 
 
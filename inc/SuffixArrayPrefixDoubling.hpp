@@ -0,0 +1,223 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "typeChecks.hpp"
+#include "BuildContext.hpp"
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/task_scheduler_init.h"
+
+///Template-Function-Object for creating a suffix-array by parallel prefix-doubling
+template<typename alph=char, typename idxT=size_t>
+class SuffixArrayPrefixDoubling{
+   ///This is the prefix-doubling of N.J. Larsson and K. Sadakane ("qsufsort"), parallelized with **TBB**.
+   ///
+   ///- typename *alph*
+   ///> type of elements of the input-vector
+   ///
+   ///- typename idxT
+   ///> determines type of indices, stored in the final suffix-array
+   ///
+   ///The suffix-array is split into groups of suffixes, that share their first *h* characters.
+   ///The rank of a suffix is the last index of its group, so every group is refined
+   ///by the ranks *h* positions further, then *h* is doubled. Groups of one suffix are sorted and never touched again,
+   ///so the work stays O(n log n) (expected), no matter how repetitive the input is.
+   ///
+   ///Every round first reads the keys of all unsorted groups, then sorts the groups and writes their new ranks.
+   ///So the groups of one round are independent and sorted in parallel, big groups are split by a parallel ternary-quicksort.
+   ///
+   ///With a *BuildContext* the suffix-array, the ranks, the keys and the groups are taken from its pools.
+private:
+   ///unsorted group SA[first, second], its suffixes share their first *h* characters
+   typedef std::pair<idxT, idxT> Group;
+   ///unsorted groups found by each thread during one round
+   typedef tbb::enumerable_thread_specific<std::vector<Group>> LocalGroups;
+public:
+   ///- *operator()*, takes a *std::vector* of type *alph* as argument
+   ///- returns a *std::vector* of type *idxT* (final suffix-array)
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max) const {
+      checkIndexType<idxT>();
+      checkDataSizeIdxT<idxT>(alph_cont.size());
+
+      tbb::task_scheduler_init tbb_init;
+
+      const idxT n = alph_cont.size();
+      std::vector<idxT> SA = takeBuffer<idxT>(ctx, n + 1);
+      std::vector<idxT> ranks = takeBuffer<idxT>(ctx, n + 1);
+      std::vector<idxT> keys = takeBuffer<idxT>(ctx, n + 1);
+      ///1. all suffixes are one group, keyed by their first *k* characters, the empty suffix n is the smallest
+      const uint64_t sigma = uint64_t(max - subtract) + 2;
+      idxT k = 1;
+      uint64_t range = sigma;
+      while(k < n && range <= uint64_t(idxT(-1)) / sigma){
+         range *= sigma;
+         ++k;
+      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, n + 1),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(idxT i = r.begin() ; i < r.end() ; ++i){
+            SA[i] = i;
+            keys[i] = packedKey(alph_cont, i, k, sigma);
+         }
+      });
+      std::vector<Group> groups = takeBuffer<Group>(ctx, 1, Group(0, n));
+      LocalGroups local;
+      splitGroups(groups, SA, ranks, keys, local);
+      ///2. refine the unsorted groups by the ranks *h* positions further, until every suffix has its own group
+      ///the suffixes of an unsorted group are never shorter than *h*, otherwise they would differ in the empty suffix
+      for(idxT h = k ; !groups.empty() ; h <<= 1){
+         tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size()),
+                           [&](const tbb::blocked_range<size_t>& r){
+            for(size_t g = r.begin() ; g < r.end() ; ++g){
+               readKeys(groups[g], h, SA, ranks, keys);
+            }
+         });
+         splitGroups(groups, SA, ranks, keys, local);
+      }
+      giveBuffer(ctx, ranks);
+      giveBuffer(ctx, keys);
+      giveBuffer(ctx, groups);
+      return SA;
+   }
+
+   ///constructor sets the value of the smallest character and the optional context, whose buffers are used
+   SuffixArrayPrefixDoubling(const idxT& min, BuildContext* context=nullptr)
+   : subtract(min), ctx(context)
+   {}
+
+private:
+   ///groups smaller than this are sorted by insertion-sort
+   static const size_t SmallGroup = 16;
+   ///groups bigger than this read their keys and sort their parts with multiple threads
+   static const size_t ParallelGroup = 1 << 14;
+
+   ///first *k* characters of the suffix *i* as number to the base *sigma*, characters behind the end count as 0
+   idxT packedKey(const std::vector<alph>& alph_cont,
+                  const idxT& i,
+                  const idxT& k,
+                  const uint64_t& sigma) const {
+      uint64_t key = 0;
+      for(idxT j = i ; j < i + k ; ++j){
+         key = key * sigma + (j < alph_cont.size() ? uint64_t(alph_cont[j] - subtract) + 1 : 0);
+      }
+      return key;
+   }
+
+   ///reads the rank *h* positions behind every suffix of *group* into *keys*, *ranks* are only read
+   void readKeys(const Group& group,
+                 const idxT& h,
+                 const std::vector<idxT>& SA,
+                 const std::vector<idxT>& ranks,
+                 std::vector<idxT>& keys) const {
+      if(group.second - group.first < ParallelGroup){
+         for(idxT j = group.first ; j <= group.second ; ++j){
+            keys[j] = ranks[SA[j] + h];
+         }
+         return;
+      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(group.first, group.second + 1),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(idxT j = r.begin() ; j < r.end() ; ++j){
+            keys[j] = ranks[SA[j] + h];
+         }
+      });
+   }
+
+   ///sorts every group by its keys and writes the new ranks, *groups* is replaced by the groups, that are still unsorted
+   void splitGroups(std::vector<Group>& groups,
+                    std::vector<idxT>& SA,
+                    std::vector<idxT>& ranks,
+                    std::vector<idxT>& keys,
+                    LocalGroups& local) const {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size()),
+                        [&](const tbb::blocked_range<size_t>& r){
+         for(size_t g = r.begin() ; g < r.end() ; ++g){
+            sortGroup(groups[g].first, groups[g].second + 1, SA, ranks, keys, local);
+         }
+      });
+      groups.clear();
+      for(auto it = local.begin() ; it != local.end() ; ++it){
+         groups.insert(groups.end(), it->begin(), it->end());
+         it->clear();
+      }
+   }
+
+   ///ternary-quicksort of SA[b, e) by keys[b, e), the parts of equal keys become new groups
+   void sortGroup(idxT b,
+                  idxT e,
+                  std::vector<idxT>& SA,
+                  std::vector<idxT>& ranks,
+                  std::vector<idxT>& keys,
+                  LocalGroups& local) const {
+      std::vector<Group>& found = local.local();
+      while(e - b >= SmallGroup){
+         const idxT x = keys[b], y = keys[b + ((e - b) >> 1)], z = keys[e - 1];
+         const idxT v = x < y ? (y < z ? y : (x < z ? z : x))
+                              : (y > z ? y : (x > z ? z : x));
+         ///SA[b, lt) < v, SA[lt, i) == v, SA[i, gt) unread, SA[gt, e) > v
+         idxT lt = b, i = b, gt = e;
+         while(i < gt){
+            if(keys[i] < v)
+               swapEntries(lt++, i++, SA, keys);
+            else if(keys[i] > v)
+               swapEntries(i, --gt, SA, keys);
+            else
+               ++i;
+         }
+         newGroup(lt, gt, SA, ranks, found);
+         if(lt - b > ParallelGroup && e - gt > ParallelGroup){
+            tbb::parallel_invoke([&](){ sortGroup(b, lt, SA, ranks, keys, local); },
+                                 [&](){ sortGroup(gt, e, SA, ranks, keys, local); });
+            return;
+         }
+         ///the smaller part is sorted recursively, the bigger part in this loop
+         if(lt - b < e - gt){
+            sortGroup(b, lt, SA, ranks, keys, local);
+            b = gt;
+         }
+         else{
+            sortGroup(gt, e, SA, ranks, keys, local);
+            e = lt;
+         }
+      }
+      for(idxT i = b + 1 ; i < e ; ++i){
+         for(idxT j = i ; j > b && keys[j - 1] > keys[j] ; --j)
+            swapEntries(j - 1, j, SA, keys);
+      }
+      for(idxT i = b ; i < e ; ){
+         idxT j = i + 1;
+         while(j < e && keys[j] == keys[i])
+            ++j;
+         newGroup(i, j, SA, ranks, found);
+         i = j;
+      }
+   }
+
+   ///SA[b, e) is one group, its rank is its last index, it stays unsorted, if it holds more than one suffix
+   void newGroup(const idxT& b,
+                 const idxT& e,
+                 const std::vector<idxT>& SA,
+                 std::vector<idxT>& ranks,
+                 std::vector<Group>& found) const {
+      for(idxT i = b ; i < e ; ++i){
+         ranks[SA[i]] = e - 1;
+      }
+      if(e - b > 1)
+         found.push_back(Group(b, e - 1));
+   }
+
+   void swapEntries(const idxT& a, const idxT& b, std::vector<idxT>& SA, std::vector<idxT>& keys) const {
+      std::swap(SA[a], SA[b]);
+      std::swap(keys[a], keys[b]);
+   }
+
+   const idxT subtract;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cctype>
+#include <cstdint>
+#include "SuffixArrayInducedSorting_bu0.hpp"
+
+///bit 3 of the header-byte of a stored suffix-array: the suffix-array only holds the sampled suffixes,
+///their count is stored in front of it
+const unsigned char SparseHeaderBit = 1 << 3;
+
+///rules for the positions of a sparse suffix-array
+enum class SparseSampling{
+   ///index 0 and every index behind a whitespace
+   Space,
+   ///index 0 and every index behind a whitespace or a punctuation-character
+   Punct,
+   ///every *step*-th index
+   Step
+};
+
+///Template-Function-Object for creating a sparse suffix-array, that only holds the suffixes starting at sampled positions
+template<typename alph=char, typename idxT=size_t>
+class SuffixArraySparse{
+   ///The segment of a sampled position reaches to the next sampled position. By *Space* and *Punct* every segment
+   ///ends with its only delimiter, by *Step* all segments have the same length, so no segment is a proper prefix of another one,
+   ///except the last segment, which is followed by the end of the input.
+   ///Two sampled suffixes differ first inside of their first differing segments, so the order of the sequences of the
+   ///names of the segments is the order of the sampled suffixes, as described by P. Ferragina and J. Fischer in "Suffix Arrays on Words".
+   ///
+   ///The distinct segments are collected in a hash-table (see *nameSegments*), only they are sorted by comparing them,
+   ///every segment is named by the rank of its distinct segment and the sequence of names is sorted by *SuffixArrayInducedSorting*.
+   ///So besides the input the build takes a few indices per sampled suffix instead of per char.
+   ///
+   ///Like the other algorithms the first entry is the size of the input (empty suffix).
+public:
+   explicit SuffixArraySparse(const SparseSampling& sampling, const idxT& step=1)
+   : rule(sampling), k(step)
+   {}
+
+   ///the biggest char is not needed, the segments are named by comparing them
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont, const idxT&) const {
+      const idxT n = alph_cont.size();
+      ///1. the sampled positions
+      std::vector<idxT> pos;
+      for(idxT i = 0 ; i < n ; i = next(alph_cont, i)){
+         pos.push_back(i);
+      }
+      const idxT m = pos.size();
+
+      ///2. naming the segments by the ranks of the distinct segments, equal segments get the same name
+      std::vector<idxT> names(m);
+      std::vector<idxT> distinct = nameSegments(alph_cont, pos, names);
+      const idxT count = distinct.size();
+
+      ///3. unique names are sorted already, otherwise the sequence of names is sorted
+      std::vector<idxT> SA;
+      if(count == m){
+         SA.resize(uint64_t(m) + 1);
+         for(idxT r = 0 ; r < m ; ++r)
+            SA[r+1] = pos[distinct[r]];
+      }
+      else{
+         std::vector<idxT>().swap(distinct);
+         SA = SuffixArrayInducedSorting<idxT,idxT>(1)(names, count);
+         for(idxT r = 1 ; r <= m ; ++r)
+            SA[r] = pos[SA[r]];
+      }
+      SA[0] = n;
+      return SA;
+   }
+
+private:
+   ///sets the names (1 for the smallest) of all segments, returns the first sampled segment of every distinct segment ordered by their ranks
+   std::vector<idxT> nameSegments(const std::vector<alph>& alph_cont,
+                                  const std::vector<idxT>& pos,
+                                  std::vector<idxT>& names) const {
+      const idxT m = pos.size();
+      auto begin = [&](const idxT& r){
+         return alph_cont.begin() + pos[r];
+      };
+      auto end = [&](const idxT& r){
+         return alph_cont.begin() + (r + 1 < m ? uint64_t(pos[r+1]) : alph_cont.size());
+      };
+      auto hash = [&](const idxT& r){
+         uint64_t h = 0xcbf29ce484222325;
+         for(auto it = begin(r) ; it != end(r) ; ++it)
+            h = (h ^ uint64_t(*it)) * 0x100000001b3;
+         return h ^ (h >> 29);
+      };
+      ///1. open addressing, every slot holds a distinct segment + 1 or 0, the table is kept at most half full
+      std::vector<idxT> distinct;
+      std::vector<idxT> table(1024, 0);
+      for(idxT r = 0 ; r < m ; ++r){
+         const uint64_t h = hash(r);
+         size_t slot = h & (table.size() - 1);
+         while(table[slot] && !(end(r) - begin(r) == end(distinct[table[slot]-1]) - begin(distinct[table[slot]-1])
+                                && std::equal(begin(r), end(r), begin(distinct[table[slot]-1]))))
+            slot = (slot + 1) & (table.size() - 1);
+         if(table[slot]){
+            names[r] = table[slot];
+         }
+         else{
+            distinct.push_back(r);
+            table[slot] = names[r] = distinct.size();
+            if(distinct.size() * 2 > table.size()){
+               std::vector<idxT>(table.size() * 2, 0).swap(table);
+               for(idxT d = 0 ; d < distinct.size() ; ++d){
+                  size_t s = hash(distinct[d]) & (table.size() - 1);
+                  while(table[s])
+                     s = (s + 1) & (table.size() - 1);
+                  table[s] = d + 1;
+               }
+            }
+         }
+      }
+      std::vector<idxT>().swap(table);
+      ///2. sorting the distinct segments, a last segment, which is a prefix of another one, is smaller
+      std::vector<idxT> order(distinct.size());
+      std::iota(order.begin(), order.end(), idxT(0));
+      std::sort(order.begin(), order.end(), [&](const idxT& a, const idxT& b){
+         return std::lexicographical_compare(begin(distinct[a]), end(distinct[a]),
+                                             begin(distinct[b]), end(distinct[b]));
+      });
+      std::vector<idxT> sorted(distinct.size());
+      for(idxT d = 0 ; d < order.size() ; ++d)
+         sorted[d] = distinct[order[d]];
+      for(idxT d = 0 ; d < order.size() ; ++d)
+         distinct[order[d]] = d + 1;
+      ///3. the names are the ranks of the distinct segments
+      for(idxT r = 0 ; r < m ; ++r)
+         names[r] = distinct[names[r]-1];
+      return sorted;
+   }
+
+   ///next sampled position behind i, n if there is none
+   idxT next(const std::vector<alph>& alph_cont, idxT i) const {
+      if(rule == SparseSampling::Step)
+         return std::min<uint64_t>(uint64_t(i) + k, alph_cont.size());
+      while(i < alph_cont.size() && !isDelimiter(alph_cont[i]))
+         ++i;
+      return i + (i < alph_cont.size());
+   }
+
+   bool isDelimiter(const alph& c) const {
+      return uint64_t(c) < 128 && (std::isspace(int(c)) || (rule == SparseSampling::Punct && std::ispunct(int(c))));
+   }
+
+   const SparseSampling rule;
+   const idxT k;
+};
@@ -0,0 +1,462 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "typeChecks.hpp"
+#include "LSTypeBits.hpp"
+#include "BuildContext.hpp"
+
+///Template-Function-Object for creating a suffix-array by sorting the LMS-suffixes first and inducing all others from them
+template<typename alph=char, typename idxT=size_t>
+class SuffixArrayTwoStage{
+   ///Two-stage suffix-sorting in the manner of Itoh-Tanaka and Y. Mori's "divsufsort":
+   ///
+   ///- typename *alph*
+   ///> type of elements of the input-vector
+   ///
+   ///- typename idxT
+   ///> determines type of indices, stored in the final suffix-array
+   ///
+   ///1. only the LMS-suffixes (at most half of all suffixes) are sorted directly:
+   ///their LMS-substrings are sorted by multikey-quicksort, LMS-suffixes with equal LMS-substrings
+   ///are sorted by the prefix-doubling of N.J. Larsson and K. Sadakane on the string of LMS-substrings
+   ///2. one L-Type and one S-Type induce-sort-step put all other suffixes behind them
+   ///
+   ///Unlike *SuffixArrayInducedSorting* there is no recursion, the sorted LMS-suffixes and the doubling-groups
+   ///all live in the output-array, beside it only the bit-packed types and the buckets are allocated.
+   ///The highest bit of *idxT* marks sorted groups during the doubling, so the input must be smaller than half of the range of *idxT*.
+   ///
+   ///With a *BuildContext* the output-array, the types and the buckets are taken from its pools.
+public:
+   ///- *operator()*, takes a *std::vector* of type *alph* as argument
+   ///- returns a *std::vector* of type *idxT* (final suffix-array)
+   std::vector<idxT> operator()(const std::vector<alph>& alph_cont,
+                                const idxT& max) const {
+      checkIndexType<idxT>();
+      checkDataSizeTwoStage(alph_cont.size());
+
+      const idxT n = alph_cont.size();
+      std::vector<idxT> SA = takeBuffer<idxT>(ctx, n+1, invalid);
+      ///Sets first element of the suffix-array as the empty(smallest) suffix
+      SA[0] = n;
+      if(n < 2){
+         if(n)
+            SA[1] = 0;
+         return SA;
+      }
+
+      LSTypeBits<idxT> STypes(alph_cont, ctx);
+      std::vector<idxT> counts = takeBuffer<idxT>(ctx, max - subtract + 1, 0);
+      for(auto it = alph_cont.begin() ; it != alph_cont.end() ; ++it){
+         ++counts[(*it) - subtract];
+      }
+
+      ///1. sort the LMS-suffixes into SA[1, m]
+      const idxT m = sortLMS(alph_cont, STypes, SA);
+
+      ///2. move the sorted LMS-suffixes to the ends of their buckets, from the biggest to the smallest
+      std::vector<idxT> buckets = takeBuffer<idxT>(ctx, counts.size());
+      make_buckets(counts, buckets, false);
+      std::fill(SA.begin() + m + 1, SA.end(), invalid);
+      for(idxT i = m ; i ; --i){
+         const idxT idx = SA[i];
+         SA[i] = invalid;
+         SA[buckets[alph_cont[idx] - subtract]] = idx;
+         --(buckets[alph_cont[idx] - subtract]);
+      }
+
+      ///3. induce sort L-Types from the heads, then S-Types from the tails of the buckets
+      make_buckets(counts, buckets, true);
+      for(idxT i = 0 ; i <= n ; ++i){
+         const idxT idx = SA[i];
+         if(idx != invalid && idx && !STypes.isS(idx - 1)){
+            SA[buckets[alph_cont[idx - 1] - subtract]] = idx - 1;
+            ++(buckets[alph_cont[idx - 1] - subtract]);
+         }
+      }
+      make_buckets(counts, buckets, false);
+      for(idxT i = n ; i ; --i){
+         const idxT idx = SA[i];
+         if(idx != invalid && idx && STypes.isS(idx - 1)){
+            SA[buckets[alph_cont[idx - 1] - subtract]] = idx - 1;
+            --(buckets[alph_cont[idx - 1] - subtract]);
+         }
+      }
+      STypes.release(ctx);
+      giveBuffer(ctx, counts);
+      giveBuffer(ctx, buckets);
+      return SA;
+   }
+
+   ///constructor sets the invalid index to max of idxT, the mark to the highest bit of idxT and the optional context, whose buffers are used
+   SuffixArrayTwoStage(const idxT& min, BuildContext* context=nullptr)
+   : invalid(-1), mark_bit(invalid - (invalid >> 1)), subtract(min), ctx(context)
+   {}
+
+private:
+   ///checks if the biggest index (input-data-byte-count) leaves the highest bit of idxT unused
+   void checkDataSizeTwoStage(const size_t& data_size) const {
+      if(data_size >= (invalid >> 1)){
+         std::cerr << "ERROR : Input has too many positions for index-type(idxT) of the two-stage suffix-sorting!!!\n";
+         exit(1);
+      }
+   }
+
+   void make_buckets(const std::vector<idxT>& counts, std::vector<idxT>& buckets, const bool& heads) const {
+      ///heads start at 1, because 0 is the empty suffix
+      buckets.resize(counts.size());
+      idxT sum = heads ? 1 : 0;
+      for(idxT c = 0 ; c < counts.size() ; ++c){
+         if(heads){
+            buckets[c] = sum;
+            sum += counts[c];
+         }
+         else{
+            sum += counts[c];
+            buckets[c] = sum;
+         }
+      }
+   }
+
+   ///compares the LMS-substrings starting at *a* and *b* by their characters and types (L before S) from depth *d* on, returns -1, 0 or 1
+   int compareLMSSubstrings(const std::vector<alph>& alph_cont,
+                            const LSTypeBits<idxT>& STypes,
+                            const idxT& a,
+                            const idxT& b,
+                            const idxT& d) const {
+      ///A LMS-substring cannot be a proper prefix of another one, the first index,
+      ///that is LMS-char in one of them after the start, is the end of both.
+      const idxT n = alph_cont.size();
+      for(idxT i = a + d, j = b + d ; ; ++i, ++j){
+         if(i == n || j == n)
+            return i == j ? 0 : (i == n ? -1 : 1);
+         if(alph_cont[i] != alph_cont[j])
+            return alph_cont[i] < alph_cont[j] ? -1 : 1;
+         const bool s_i = STypes.isS(i);
+         if(s_i != STypes.isS(j))
+            return s_i ? 1 : -1;
+         if(i != a && STypes.isLMS(i))
+            return 0;
+      }
+   }
+
+   ///key of the LMS-substring starting at *a* at depth *d*, character and type (L before S), the empty suffix is the smallest
+   uint64_t substringKey(const std::vector<alph>& alph_cont,
+                         const LSTypeBits<idxT>& STypes,
+                         const idxT& a,
+                         const idxT& d) const {
+      const idxT i = a + d;
+      if(i == alph_cont.size())
+         return 0;
+      return ((uint64_t(alph_cont[i] - subtract) + 1) << 1) | uint64_t(STypes.isS(i));
+   }
+
+   ///multikey-quicksort of the LMS-substrings *p*[0, k), that are equal up to depth *d*,
+   ///the first index of every group of equal LMS-substrings is marked
+   void multikeySort(const std::vector<alph>& alph_cont,
+                     const LSTypeBits<idxT>& STypes,
+                     idxT* p,
+                     idxT k,
+                     idxT d) const {
+      ///Every key of a LMS-substring is read once per partition-step, instead of once per comparison,
+      ///and the prefix of a group is never compared again.
+      while(k > 1){
+         if(k < 16){
+            for(idxT* pi = p + 1 ; pi < p + k ; ++pi){
+               for(idxT* pj = pi ; pj > p && compareLMSSubstrings(alph_cont, STypes, *(pj - 1), *pj, d) > 0 ; --pj)
+                  std::swap(*(pj - 1), *pj);
+            }
+            for(idxT* pi = p + k - 1 ; pi > p ; --pi){
+               if(compareLMSSubstrings(alph_cont, STypes, *(pi - 1), *pi, d))
+                  *pi |= mark_bit;
+            }
+            *p |= mark_bit;
+            return;
+         }
+         const uint64_t a = substringKey(alph_cont, STypes, p[0], d);
+         const uint64_t b = substringKey(alph_cont, STypes, p[k >> 1], d);
+         const uint64_t c = substringKey(alph_cont, STypes, p[k - 1], d);
+         const uint64_t v = a < b ? (b < c ? b : (a < c ? c : a))
+                                  : (b > c ? b : (a > c ? c : a));
+         ///ternary split into *p*[0, s) < v, *p*[s, k-t) == v, *p*[k-t, k) > v
+         idxT* pa = p;
+         idxT* pb = p;
+         idxT* pc = p + k - 1;
+         idxT* pd = p + k - 1;
+         while(true){
+            uint64_t f;
+            while(pb <= pc && (f = substringKey(alph_cont, STypes, *pb, d)) <= v){
+               if(f == v){
+                  std::swap(*pa, *pb);
+                  ++pa;
+               }
+               ++pb;
+            }
+            while(pc >= pb && (f = substringKey(alph_cont, STypes, *pc, d)) >= v){
+               if(f == v){
+                  std::swap(*pc, *pd);
+                  --pd;
+               }
+               --pc;
+            }
+            if(pb > pc)
+               break;
+            std::swap(*pb, *pc);
+            ++pb;
+            --pc;
+         }
+         idxT* pn = p + k;
+         idxT r = std::min<idxT>(pa - p, pb - pa);
+         for(idxT* pl = p, * pm = pb - r ; r ; --r, ++pl, ++pm)
+            std::swap(*pl, *pm);
+         r = std::min<idxT>(pd - pc, pn - pd - 1);
+         for(idxT* pl = pb, * pm = pn - r ; r ; --r, ++pl, ++pm)
+            std::swap(*pl, *pm);
+
+         const idxT s = pb - pa;
+         const idxT t = pd - pc;
+         multikeySort(alph_cont, STypes, p, s, d);
+         multikeySort(alph_cont, STypes, p + k - t, t, d);
+         ///the equal part continues with the next character, unless its LMS-substrings or the input end here
+         p += s;
+         k -= s + t;
+         const idxT i = *p + d;
+         if(i == alph_cont.size() || (d && STypes.isLMS(i))){
+            *p |= mark_bit;
+            return;
+         }
+         ++d;
+      }
+      if(k)
+         *p |= mark_bit;
+   }
+
+   ///sorts all LMS-suffixes and stores them in SA[1, m], returns m
+   idxT sortLMS(const std::vector<alph>& alph_cont,
+                const LSTypeBits<idxT>& STypes,
+                std::vector<idxT>& SA) const {
+      ///1. SA[0, m) holds the LMS-indices sorted by their LMS-substrings, the first index of every group is marked
+      ///2. the rank q of a LMS-index p among all LMS-indices is stored at SA[m + p/2], LMS-chars are never neighbours
+      ///3. the groups are turned into the start of the prefix-doubling on the string of LMS-substrings:
+      ///*I* = SA[0, m] holds the ranks q in sorted order behind the sentinel, *V* = SA[n-m, n] the group of every rank q
+      ///4. the prefix-doubling sorts the LMS-suffixes, that still share a group
+      ///5. the sorted ranks are mapped back to their LMS-indices
+      const idxT n = alph_cont.size();
+      idxT m = 0;
+      STypes.forEachLMS([&](const idxT& i){
+         SA[m++] = i;
+      });
+      if(!m){
+         SA[0] = n;
+         return 0;
+      }
+      multikeySort(alph_cont, STypes, &SA[0], m, 0);
+
+      idxT q = 0;
+      STypes.forEachLMS([&](const idxT& i){
+         SA[m + (i >> 1)] = q++;
+      });
+      for(idxT j = 0 ; j < m ; ++j){
+         SA[j] = (SA[j] & mark_bit) | SA[m + ((SA[j] & ~mark_bit) >> 1)];
+      }
+
+      ///the group of a rank is the index of the last member of its group in *I*, a group of one is already sorted
+      idxT* V = &SA[n - m];
+      idxT* I = &SA[0];
+      idxT g = m;
+      bool last = true;
+      for(idxT j = m ; j ; --j){
+         const idxT r = SA[j - 1] & ~mark_bit;
+         const bool first = SA[j - 1] & mark_bit;
+         if(last)
+            g = j;
+         V[r] = g;
+         I[j] = first && last ? idxT(mark_bit | 1) : r;
+         last = first;
+      }
+      I[0] = mark_bit | 1;
+      V[m] = 0;
+      DoublingSort sorter(I, V, m, mark_bit);
+
+      idxT k = 0;
+      STypes.forEachLMS([&](const idxT& i){
+         V[k++] = i;
+      });
+      for(idxT i = 1 ; i <= m ; ++i){
+         I[i] = V[I[i]];
+      }
+      I[0] = n;
+      return m;
+   }
+
+   ///Larsson-Sadakane prefix-doubling ("qsufsort") of the suffixes of a string of length *n*, that are already sorted by their first symbol
+   class DoublingSort{
+      ///- *I*[0, n] becomes the suffix-array, *V*[0, n] its inverse, the suffix n is the unique smallest
+      ///- sorted groups in *I* are marked with *mark* and store their length, single sorted suffixes are skipped as groups of length 1
+      ///- the group-number of a suffix in *V* is the last index of its group in *I*,
+      ///so every unsorted group is refined by the group-numbers *h* positions further (ternary-split-quicksort)
+      ///- each round doubles *h*, at most log(n) rounds of O(n) expected work
+   public:
+      DoublingSort(idxT* I, idxT* V, const idxT& n, const idxT& mark)
+      : I(I), V(V), h(1), mark(mark)
+      {
+         while(!((*I & mark) && (*I & ~mark) == n + 1)){
+            idxT* pi = I;
+            idxT sl = 0;
+            do{
+               const idxT s = *pi;
+               if(s & mark){
+                  pi += s & ~mark;
+                  sl += s & ~mark;
+               }
+               else{
+                  if(sl){
+                     *(pi - sl) = mark | sl;
+                     sl = 0;
+                  }
+                  idxT* pk = I + V[s] + 1;
+                  sort_split(pi, pk - pi);
+                  pi = pk;
+               }
+            }while(pi <= I + n);
+            if(sl)
+               *(pi - sl) = mark | sl;
+            h <<= 1;
+         }
+         for(idxT i = 0 ; i <= n ; ++i){
+            I[V[i]] = i;
+         }
+      }
+
+   private:
+      idxT key(const idxT* p) const {
+         return V[*p + h];
+      }
+
+      ///sets the group-number of *pl*..*pm* to the index of *pm*, a group of one is sorted
+      void update_group(idxT* pl, idxT* pm){
+         const idxT g = pm - I;
+         V[*pl] = g;
+         if(pl == pm){
+            *pl = mark | 1;
+         }
+         else{
+            do{
+               V[*++pl] = g;
+            }while(pl < pm);
+         }
+      }
+
+      ///selection-sort for small groups, picks out the group of the smallest key repeatedly
+      void select_sort_split(idxT* p, const idxT& n){
+         idxT* pa = p;
+         idxT* pn = p + n - 1;
+         while(pa < pn){
+            idxT* pb = pa + 1;
+            idxT f = key(pa);
+            for(idxT* pi = pa + 1 ; pi <= pn ; ++pi){
+               const idxT v = key(pi);
+               if(v < f){
+                  f = v;
+                  std::swap(*pi, *pa);
+                  pb = pa + 1;
+               }
+               else if(v == f){
+                  std::swap(*pi, *pb);
+                  ++pb;
+               }
+            }
+            update_group(pa, pb - 1);
+            pa = pb;
+         }
+         if(pa == pn){
+            V[*pa] = pa - I;
+            *pa = mark | 1;
+         }
+      }
+
+      idxT* med3(idxT* a, idxT* b, idxT* c) const {
+         return key(a) < key(b) ? (key(b) < key(c) ? b : (key(a) < key(c) ? c : a))
+                                : (key(b) > key(c) ? b : (key(a) > key(c) ? c : a));
+      }
+
+      idxT choose_pivot(idxT* p, const idxT& n) const {
+         idxT* pm = p + (n >> 1);
+         if(n > 7){
+            idxT* pl = p;
+            idxT* pn = p + n - 1;
+            if(n > 40){
+               const idxT s = n >> 3;
+               pl = med3(pl, pl + s, pl + s + s);
+               pm = med3(pm - s, pm, pm + s);
+               pn = med3(pn - s - s, pn - s, pn);
+            }
+            pm = med3(pl, pm, pn);
+         }
+         return key(pm);
+      }
+
+      ///ternary-split-quicksort of the group *p*[0, n) by key, the smaller and bigger parts are sorted recursively
+      void sort_split(idxT* p, const idxT& n){
+         if(n < 7){
+            select_sort_split(p, n);
+            return;
+         }
+         const idxT v = choose_pivot(p, n);
+         idxT* pa = p;
+         idxT* pb = p;
+         idxT* pc = p + n - 1;
+         idxT* pd = p + n - 1;
+         while(true){
+            idxT f;
+            while(pb <= pc && (f = key(pb)) <= v){
+               if(f == v){
+                  std::swap(*pa, *pb);
+                  ++pa;
+               }
+               ++pb;
+            }
+            while(pc >= pb && (f = key(pc)) >= v){
+               if(f == v){
+                  std::swap(*pc, *pd);
+                  --pd;
+               }
+               --pc;
+            }
+            if(pb > pc)
+               break;
+            std::swap(*pb, *pc);
+            ++pb;
+            --pc;
+         }
+         idxT* pn = p + n;
+         idxT s = std::min<idxT>(pa - p, pb - pa);
+         for(idxT* pl = p, * pm = pb - s ; s ; --s, ++pl, ++pm)
+            std::swap(*pl, *pm);
+         s = std::min<idxT>(pd - pc, pn - pd - 1);
+         for(idxT* pl = pb, * pm = pn - s ; s ; --s, ++pl, ++pm)
+            std::swap(*pl, *pm);
+
+         s = pb - pa;
+         const idxT t = pd - pc;
+         if(s > 0)
+            sort_split(p, s);
+         update_group(p + s, p + n - t - 1);
+         if(t > 0)
+            sort_split(p + n - t, t);
+      }
+
+      idxT* I;
+      idxT* V;
+      idxT h;
+      const idxT mark;
+   };
+
+   ///invalid index
+   const idxT invalid;
+   ///highest bit of *idxT*
+   const idxT mark_bit;
+   const idxT subtract;
+   ///context of the buffers, *nullptr* allocates them for every build
+   BuildContext* const ctx;
+};
@@ -0,0 +1,200 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <type_traits>
+#include <cctype>
+#include <cstdint>
+#include "SuffixArrayInducedSorting_bu0.hpp"
+
+///bit 6 of the header-byte of a stored suffix-array: the suffix-array only holds the starts of tokens
+const unsigned char TokenHeaderBit = 1 << 6;
+
+///Suffix-array over the tokens (words) of a corpus instead of every character
+template<typename alph=unsigned char, typename idxT=size_t>
+class TokenSuffixArray{
+   ///- a token is a maximal run of letters and digits (characters above 127 count as letters, so UTF-8-words stay whole)
+   ///or a single other character, whitespace only separates tokens
+   ///- every distinct token gets a dense ID from the dictionary, the IDs are ordered like the tokens,
+   ///so *SuffixArrayInducedSorting* on the sequence of IDs orders the suffixes like their token-sequences
+   ///- the suffix-array stores the positions of the first characters of the tokens in the corpus,
+   ///the first entry is the size of the corpus (empty suffix)
+public:
+   ///type of the dense IDs of the tokens
+   typedef uint32_t TokenID;
+
+   ///builds the dictionary and the suffix-array of the tokens of *data*
+   void build(const std::vector<alph>& data){
+      const idxT n = data.size();
+      ///1. split into tokens and give every new token the next ID
+      std::vector<idxT> starts;
+      std::vector<TokenID> ids;
+      std::unordered_map<std::string, TokenID> id_of;
+      for(idxT i = skipSpace(data, 0) ; i < n ; i = skipSpace(data, i)){
+         const idxT e = tokenEnd(data, i);
+         const auto it = id_of.emplace(std::string(data.begin() + i, data.begin() + e), TokenID(id_of.size())).first;
+         starts.push_back(i);
+         ids.push_back(it->second);
+         if(id_of.size() > size_t(TokenID(-1))){
+            std::cerr << "ERROR : too many distinct tokens\n";
+            exit(1);
+         }
+         i = e;
+      }
+      if(starts.empty()){
+         std::cerr << "ERROR : No tokens in data file\n";
+         exit(1);
+      }
+      ///2. renumber the IDs in the order of the sorted dictionary
+      dict.clear();
+      dict.reserve(id_of.size());
+      for(const auto& t : id_of){
+         dict.push_back(t.first);
+      }
+      std::sort(dict.begin(), dict.end());
+      std::vector<TokenID> rank(dict.size());
+      for(TokenID r = 0 ; r < dict.size() ; ++r){
+         rank[id_of[dict[r]]] = r;
+      }
+      id_of.clear();
+      for(TokenID& id : ids){
+         id = rank[id];
+      }
+      ///3. suffix-array of the IDs, mapped back to the positions of the tokens
+      if(ids.size() < 2){
+         SA = {idxT(ids.size()), idxT(0)};
+      }
+      else{
+         SA = SuffixArrayInducedSorting<TokenID, idxT>(0)(ids, dict.size() - 1);
+      }
+      SA[0] = n;
+      for(idxT j = 1 ; j < SA.size() ; ++j){
+         SA[j] = starts[SA[j]];
+      }
+   }
+
+   ///range of the suffix-array, whose suffixes start with the tokens of *phrase*,
+   ///(SA.size(), SA.size()) if the phrase is not found
+   std::pair<idxT,idxT> find(const std::string& phrase, const std::vector<alph>& data) const {
+      const std::pair<idxT,idxT> none(SA.size(), SA.size());
+      ///1. map the phrase to tokens of the dictionary, a unknown token is never found
+      const std::vector<alph> p(phrase.begin(), phrase.end());
+      std::vector<std::string> query;
+      for(idxT i = skipSpace(p, 0) ; i < p.size() ; i = skipSpace(p, i)){
+         const idxT e = tokenEnd(p, i);
+         query.push_back(std::string(phrase.begin() + i, phrase.begin() + e));
+         if(!std::binary_search(dict.begin(), dict.end(), query.back()))
+            return none;
+         i = e;
+      }
+      if(query.empty())
+         return none;
+      ///2. binary search for the first suffix not smaller than the phrase and the first suffix bigger than the phrase,
+      ///the order of the tokens is the order of their IDs
+      idxT lo = 1, hi = SA.size();
+      while(lo < hi){
+         const idxT mid = lo + ((hi - lo) >> 1);
+         if(compare(data, SA[mid], query) < 0)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+      const idxT first = lo;
+      hi = SA.size();
+      while(lo < hi){
+         const idxT mid = lo + ((hi - lo) >> 1);
+         if(compare(data, SA[mid], query) <= 0)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+      return first == lo ? none : std::pair<idxT,idxT>(first, lo);
+   }
+
+   const std::vector<idxT>& suffixArray() const {
+      return SA;
+   }
+
+   ///binary write of the suffix-array (count of tokens, then the entries), a *false* for no lcp-lr and the dictionary
+   void write(std::ostream& out) const {
+      idxT m = SA.size() - 1;
+      out.write((char*)&m, sizeof(idxT));
+      out.write((char*)&SA[0], sizeof(idxT) * SA.size());
+      bool use_lcp = false;
+      out.write((char*)&use_lcp, sizeof(bool));
+      idxT s = dict.size();
+      out.write((char*)&s, sizeof(idxT));
+      for(const std::string& t : dict){
+         s = t.size();
+         out.write((char*)&s, sizeof(idxT));
+         out.write(t.data(), t.size());
+      }
+   }
+
+   ///reads what *write* stored
+   bool read(std::istream& in){
+      idxT m;
+      in.read((char*)&m, sizeof(idxT));
+      SA.resize(uint64_t(m) + 1);
+      in.read((char*)&SA[0], sizeof(idxT) * SA.size());
+      bool use_lcp;
+      in.read((char*)&use_lcp, sizeof(bool));
+      idxT s;
+      in.read((char*)&s, sizeof(idxT));
+      dict.resize(s);
+      for(std::string& t : dict){
+         in.read((char*)&s, sizeof(idxT));
+         t.resize(s);
+         in.read(&t[0], s);
+      }
+      return bool(in);
+   }
+
+private:
+   typedef typename std::make_unsigned<alph>::type ualph;
+
+   static bool isSpace(const alph& c){
+      return ualph(c) < 128 && std::isspace(int(ualph(c)));
+   }
+
+   static bool isWordChar(const alph& c){
+      return ualph(c) >= 128 || std::isalnum(int(ualph(c)));
+   }
+
+   ///first position from i on, that is no whitespace
+   static idxT skipSpace(const std::vector<alph>& data, idxT i){
+      while(i < data.size() && isSpace(data[i]))
+         ++i;
+      return i;
+   }
+
+   ///end of the token starting at i
+   static idxT tokenEnd(const std::vector<alph>& data, idxT i){
+      if(!isWordChar(data[i]))
+         return i + 1;
+      while(++i < data.size() && isWordChar(data[i]));
+      return i;
+   }
+
+   ///compares the first tokens of the suffix at *pos* with *query*: <0 smaller, 0 equal, >0 bigger,
+   ///a suffix with less tokens than the query is smaller
+   static int compare(const std::vector<alph>& data, idxT pos, const std::vector<std::string>& query){
+      for(const std::string& q : query){
+         pos = skipSpace(data, pos);
+         if(pos == data.size())
+            return -1;
+         const idxT e = tokenEnd(data, pos);
+         const std::string t(data.begin() + pos, data.begin() + e);
+         const int c = t.compare(q);
+         if(c)
+            return c;
+         pos = e;
+      }
+      return 0;
+   }
+
+   std::vector<std::string> dict;
+   std::vector<idxT> SA;
+};
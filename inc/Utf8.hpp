@@ -0,0 +1,91 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+///Decoding of UTF-8 into code-points (the symbols of the wide alphabets) and encoding back for printing
+
+///code-point of broken sequences
+const uint32_t Utf8Replacement = 0xFFFD;
+
+///checks if a byte continues a UTF-8-sequence, every other byte starts one symbol
+inline bool utf8Continuation(const unsigned char& c){
+   return (c & 0xC0) == 0x80;
+}
+
+///decodes the symbol starting at *p* and moves *p* behind it,
+///stray continuation-bytes behind the symbol are skipped, broken sequences become *Utf8Replacement*
+inline uint32_t utf8Decode(const unsigned char*& p, const unsigned char* end){
+   const unsigned char c = *p++;
+   unsigned len;
+   uint32_t cp;
+   if(c < 0x80){
+      len = 0;
+      cp = c;
+   }
+   else if(c >= 0xC2 && c < 0xE0){
+      len = 1;
+      cp = c & 0x1F;
+   }
+   else if(c >= 0xE0 && c < 0xF0){
+      len = 2;
+      cp = c & 0x0F;
+   }
+   else if(c >= 0xF0 && c < 0xF5){
+      len = 3;
+      cp = c & 0x07;
+   }
+   else{
+      len = 0;
+      cp = Utf8Replacement;
+   }
+   for( ; len && p != end && utf8Continuation(*p) ; --len, ++p){
+      cp = (cp << 6) | (*p & 0x3F);
+   }
+   if(len)
+      cp = Utf8Replacement;
+   while(p != end && utf8Continuation(*p))
+      ++p;
+   return cp;
+}
+
+///bytes per symbol needed for the UTF-8-text [beg, end): 4, if it holds code-points above 0xFFFF, otherwise 2
+inline unsigned utf8SymbolWidth(const unsigned char* beg, const unsigned char* end){
+   for( ; beg != end ; ++beg){
+      if(*beg >= 0xF0)
+         return 4;
+   }
+   return 2;
+}
+
+///decodes a whole string (e.g. a pattern from the command-line) into symbols of type *alph*
+template<typename alph>
+std::vector<alph> utf8DecodeString(const std::string& s){
+   std::vector<alph> out;
+   const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+   const unsigned char* end = p + s.size();
+   while(p != end && utf8Continuation(*p))
+      ++p;
+   while(p != end){
+      out.push_back(utf8Decode(p, end));
+   }
+   return out;
+}
+
+///writes the code-point *cp* as UTF-8
+inline void utf8Encode(std::ostream& out, const uint32_t& cp){
+   if(cp < 0x80){
+      out << char(cp);
+   }
+   else if(cp < 0x800){
+      out << char(0xC0 | (cp >> 6)) << char(0x80 | (cp & 0x3F));
+   }
+   else if(cp < 0x10000){
+      out << char(0xE0 | (cp >> 12)) << char(0x80 | ((cp >> 6) & 0x3F)) << char(0x80 | (cp & 0x3F));
+   }
+   else{
+      out << char(0xF0 | (cp >> 18)) << char(0x80 | ((cp >> 12) & 0x3F))
+          << char(0x80 | ((cp >> 6) & 0x3F)) << char(0x80 | (cp & 0x3F));
+   }
+}
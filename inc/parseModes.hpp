@@ -4,6 +4,27 @@ const std::string Find = "-f";
 const std::string Naive = "-n";
 const std::string NaiveParallel = "-np";
 const std::string InducedSorting = "-is";
+const std::string InducedSortingInPlace = "-isi";
+const std::string InducedSortingParallel = "-isp";
+const std::string TwoStage = "-ts";
+const std::string PrefixDoubling = "-pd";
+const std::string ExternalMemory = "-em";
+const std::string TempDir = "-td";
+const std::string MemoryCap = "-mc";
+const std::string Chunks = "-ch";
+const std::string Tokens = "-tok";
+const std::string SymbolWidth = "-sym";
+const std::string UTF8 = "-utf8";
+const std::string Stats = "-st";
+const std::string MemoryBudget = "-mb";
+const std::string Checkpoint = "-cp";
+const std::string Resume = "-resume";
+const std::string BWT = "-bwt";
+const std::string Sparse = "-sp";
+const std::string Documents = "-docs";
+const std::string Append = "-app";
+const std::string Merge = "-merge";
+const std::string ReadAhead = "-ra";
 const std::string TryCompression = "-tc";
 const std::string useLCP = "-lcp";
 const std::string SubstringWidth = "-sw";
@@ -22,12 +43,16 @@ bool parse_flag(const bool& flag){
 class Modes{
 public:
    Modes(const unsigned& argc, char**& argv)
-   : modes(8, "")
+   : modes(24, "")
    {
       modes[0] = "SA_DATA";
       modes[1] = InducedSorting;
+      modes[8] = ".";
+      modes[9] = "1024";
+      modes[12] = "8";
       std::string short_input_arg1 = "";
       std::string short_input_arg2 = "";
+      bool algorithm_given = false;
       for(unsigned i = 1 ; i < argc ; ++i){
          std::string arg = std::string(argv[i]);
          
@@ -63,14 +88,106 @@ public:
                exit(1);
             }
          }
-         else if(arg == Naive || arg == NaiveParallel || arg == InducedSorting)
+         else if(arg == TempDir){
+            if(++i < argc)
+               modes[8] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-td''\n";
+               exit(1);
+            }
+         }
+         else if(arg == MemoryCap){
+            if(++i < argc)
+               modes[9] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-mc''\n";
+               exit(1);
+            }
+         }
+         else if(arg == SymbolWidth){
+            if(++i < argc)
+               modes[12] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-sym''\n";
+               exit(1);
+            }
+            if(modes[12] != "8" && modes[12] != "16" && modes[12] != "32"){
+               std::cerr << "ERROR : symbol-width ''" << modes[12] << "'' is not 8, 16 or 32\n";
+               exit(1);
+            }
+         }
+         else if(arg == Stats){
+            if(++i < argc)
+               modes[14] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-st''\n";
+               exit(1);
+            }
+         }
+         else if(arg == MemoryBudget){
+            if(++i < argc)
+               modes[15] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-mb''\n";
+               exit(1);
+            }
+         }
+         else if(arg == Sparse){
+            if(++i < argc)
+               modes[19] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-sp''\n";
+               exit(1);
+            }
+         }
+         else if(arg == Append){
+            if(++i < argc)
+               modes[21] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-app''\n";
+               exit(1);
+            }
+         }
+         else if(arg == Merge){
+            if(++i < argc)
+               modes[22] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-merge''\n";
+               exit(1);
+            }
+         }
+         else if(arg == Chunks){
+            if(++i < argc)
+               modes[10] = std::string(argv[i]);
+            else{
+               std::cerr << "ERROR : no argument for mode ''-ch''\n";
+               exit(1);
+            }
+         }
+         else if(arg == Naive || arg == NaiveParallel || arg == InducedSorting || arg == InducedSortingInPlace || arg == InducedSortingParallel || arg == TwoStage || arg == PrefixDoubling || arg == ExternalMemory){
             modes[1] = arg;
+            algorithm_given = true;
+         }
          else if(arg == TryCompression)
             modes[5] = " ";
          else if(arg == useLCP)
             modes[6] = " ";
          else if(arg == FilterNewline)
             modes[7] = " ";
+         else if(arg == Tokens)
+            modes[11] = " ";
+         else if(arg == UTF8)
+            modes[13] = " ";
+         else if(arg == Checkpoint)
+            modes[16] = " ";
+         else if(arg == Resume)
+            modes[17] = " ";
+         else if(arg == BWT)
+            modes[18] = " ";
+         else if(arg == Documents)
+            modes[20] = " ";
+         else if(arg == ReadAhead)
+            modes[23] = " ";
          else{
             if(!short_input_arg1.size())
                short_input_arg1 = arg;
@@ -84,6 +201,10 @@ public:
             }
          }
       }
+      if(algorithm_given && modes[15].size()){
+         std::cerr << "ERROR : ''-mb'' chooses the algorithm, it can not be used with ''" << modes[1] << "''\n";
+         exit(1);
+      }
       check_short_input(argc, argv, short_input_arg1, short_input_arg2);
    }
    
@@ -115,6 +236,54 @@ public:
       
       if(key == "FilterNewline")
          return modes[7];
+      
+      if(key == "TempDir")
+         return modes[8];
+      
+      if(key == "MemoryCap")
+         return modes[9];
+      
+      if(key == "Chunks")
+         return modes[10];
+      
+      if(key == "Tokens")
+         return modes[11];
+      
+      if(key == "SymbolWidth")
+         return modes[12];
+      
+      if(key == "UTF8")
+         return modes[13];
+      
+      if(key == "Stats")
+         return modes[14];
+      
+      if(key == "MemoryBudget")
+         return modes[15];
+      
+      if(key == "Checkpoint")
+         return modes[16];
+      
+      if(key == "Resume")
+         return modes[17];
+      
+      if(key == "BWT")
+         return modes[18];
+      
+      if(key == "Sparse")
+         return modes[19];
+      
+      if(key == "Documents")
+         return modes[20];
+      
+      if(key == "Append")
+         return modes[21];
+      
+      if(key == "Merge")
+         return modes[22];
+      
+      if(key == "ReadAhead")
+         return modes[23];
       std::cerr << "ERROR : Key to Modes unknown.\n";
       exit(1);
    }
@@ -124,7 +293,11 @@ private:
                           char**& argv,
                           const std::string& arg1Inp,
                           const std::string& arg2Inf){
-      if(!modes[3].size()){
+      ///''-merge'' only reads the segmented index
+      if(modes[22].size()){
+         short_input = false;
+      }
+      else if(!modes[3].size()){
          short_input = true;
          /*if(argc == 2){
             
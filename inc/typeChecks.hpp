@@ -1,5 +1,6 @@
 #pragma once
 #include <type_traits>
+#include <cstdint>
 
 ///checks if indexType is an unsigned-type
 template<typename idxT>
@@ -18,12 +19,13 @@ void checkAlphabetType(){
    }
 }
 
-///suffix-array default index-type set to unsigned, checks if the biggest index (input-data-byte-count) is smaller than the ''invalid'' index(max of index-type).
-
+///checks if the biggest index (input-data-byte-count) is smaller than the ''invalid'' index(max of index-type).
+///The index-type is chosen at runtime from the input-size, so this only fails, if the input grew after choosing it.
 template<typename idxT>
-void checkDataSizeIdxT(idxT data_size){
-   if(data_size >= idxT(-1)){
-      std::cerr << "Input has too many positions for index-type(idxT)!!!\n";
+void checkDataSizeIdxT(const size_t& data_size){
+   if(data_size >= uint64_t(idxT(-1))){
+      std::cerr << "ERROR : Input has too many positions for index-type(idxT)!!!\n";
+      exit(1);
    }
 }
 
@@ -0,0 +1,346 @@
+#include "../inc/SuffixArrayInducedSorting_bu0.hpp"
+#include "../inc/SuffixArrayInducedSortingInPlace.hpp"
+#include "../inc/SuffixArrayInducedSortingParallel.hpp"
+#include "../inc/SuffixArrayTwoStage.hpp"
+#include "../inc/SuffixArrayPrefixDoubling.hpp"
+#include "../inc/SuffixArrayNaive.hpp"
+#include "../inc/SuffixArrayExternal.hpp"
+#include "../inc/SuffixArrayChunked.hpp"
+#include "../inc/IndexTypes.hpp"
+#include "../inc/Corpora.hpp"
+#include "tbb/task_scheduler_init.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+///Benchmark of the suffix-array-engines on synthetic corpora
+//every run is a forked process, that generates its corpus, builds the suffix-array once and reports the time through a pipe,
+//so the peak resident memory of a run (corpus + engine) is taken from the rusage of its process
+//
+//the index-type of a run is chosen like by SuffixArray (indexWidthForSize), so 2-4GB corpora are built with uint40
+//
+//usage: Benchmark [-e engines] [-c corpora] [-s sizes] [-t threads] [-timeout seconds] [-td dir] [-mc megabytes] [-json] [-o file]
+//lists are comma-separated, sizes take the suffixes K, M and G
+//-em builds from a corpus-file in -td with the memory-cap -mc, the time of writing the corpus is not counted,
+//-ch sorts as many chunks (at least two) with -is as a run has threads, its chunk-files are stored in -td
+//-isra is -is with the read-ahead of the induce-sort-steps (SuffixArray -is -ra)
+
+///engines, that use more than one thread
+const std::vector<std::string> ParallelEngines = {"-np", "-isp", "-pd", "-ch"};
+
+///all engines, that can be benchmarked
+const std::vector<std::string> Engines = {"-n", "-np", "-is", "-isra", "-isi", "-isp", "-ts", "-pd", "-em", "-ch"};
+
+///directory of the files of -em and -ch
+std::string tmp_dir = ".";
+///memory-cap of -em in megabytes
+uint64_t mem_cap = 1024;
+
+struct Result{
+   std::string engine;
+   std::string corpus;
+   uint64_t size;
+   unsigned threads;
+   ///ok, timeout or failed
+   std::string status;
+   double seconds;
+   long peak_rss_kb;
+   double efficiency;
+};
+
+std::vector<std::string> split(const std::string& list){
+   std::vector<std::string> items;
+   std::stringstream in(list);
+   std::string item;
+   while(std::getline(in, item, ',')){
+      if(item.size())
+         items.push_back(item);
+   }
+   return items;
+}
+
+uint64_t parseSize(const std::string& s){
+   size_t end = 0;
+   uint64_t size = 0;
+   try{
+      size = std::stoull(s, &end);
+   }
+   catch(...){
+      end = 0;
+   }
+   if(!end){
+      std::cerr << "ERROR : size ''" << s << "'' is no number\n";
+      exit(1);
+   }
+   const std::string unit = s.substr(end);
+   if(unit == "K")
+      size <<= 10;
+   else if(unit == "M")
+      size <<= 20;
+   else if(unit == "G")
+      size <<= 30;
+   else if(unit.size()){
+      std::cerr << "ERROR : unit of size ''" << s << "'' is not K, M or G\n";
+      exit(1);
+   }
+   if(size < 2){
+      std::cerr << "ERROR : size ''" << s << "'' is too small, a corpus needs at least two characters\n";
+      exit(1);
+   }
+   return size;
+}
+
+///builds the suffix-array of the corpus-file of *T* with *SuffixArrayExternal* and returns the seconds of the build
+template<typename idxT>
+double buildExternal(const std::vector<unsigned char>& T){
+   const std::string tag = tmp_dir + "/Benchmark_" + std::to_string(getpid());
+   const std::string in_f = tag + ".txt", out_f = tag + ".sa";
+   {
+      std::ofstream in(in_f, std::ios::binary);
+      in.write((const char*)&T[0], T.size());
+      if(!in){
+         std::cerr << "ERROR : Failed to write ''" << in_f << "''\n";
+         exit(1);
+      }
+   }
+   auto start(std::chrono::steady_clock::now());
+   SuffixArrayExternal<unsigned char,idxT>(tmp_dir, mem_cap << 20)(in_f, false, out_f, false);
+   const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+   ///header, size, text, suffix-array and the lcp-flag
+   std::ifstream out(out_f, std::ios::binary | std::ios::ate);
+   const uint64_t bytes = out.is_open() ? uint64_t(out.tellg()) : 0;
+   std::remove(in_f.c_str());
+   std::remove(out_f.c_str());
+   if(bytes != 1 + sizeof(idxT) + T.size() + (T.size() + 1) * sizeof(idxT) + sizeof(bool)){
+      std::cerr << "ERROR : engine ''-em'' wrote " << bytes << " bytes for " << T.size() << " characters\n";
+      exit(1);
+   }
+   return seconds;
+}
+
+///builds the suffix-array of *T* with *engine* and returns the seconds of the build
+template<typename idxT>
+double build(const std::string& engine, const std::vector<unsigned char>& T, const unsigned& threads){
+   if(engine == "-em")
+      return buildExternal<idxT>(T);
+   idxT min = *std::min_element(T.begin(), T.end());
+   idxT max = *std::max_element(T.begin(), T.end());
+   std::vector<idxT> SA;
+   auto start(std::chrono::steady_clock::now());
+   if(engine == "-n")
+      SA = SuffixArrayNaive<unsigned char,idxT>(false)(T, max);
+   else if(engine == "-np")
+      SA = SuffixArrayNaive<unsigned char,idxT>(true)(T, max);
+   else if(engine == "-is")
+      SA = SuffixArrayInducedSorting<unsigned char,idxT>(min)(T, max);
+   else if(engine == "-isra")
+      SA = SuffixArrayInducedSorting<unsigned char,idxT>(min, nullptr, nullptr, nullptr, true)(T, max);
+   else if(engine == "-isi")
+      SA = SuffixArrayInducedSortingInPlace<unsigned char,idxT>(min)(T, max);
+   else if(engine == "-isp")
+      SA = SuffixArrayInducedSortingParallel<unsigned char,idxT>(min)(T, max);
+   else if(engine == "-ts")
+      SA = SuffixArrayTwoStage<unsigned char,idxT>(min)(T, max);
+   else if(engine == "-pd")
+      SA = SuffixArrayPrefixDoubling<unsigned char,idxT>(min)(T, max);
+   else if(engine == "-ch")
+      SA = SuffixArrayChunked<unsigned char,idxT,SuffixArrayInducedSorting<unsigned char,idxT>>(SuffixArrayInducedSorting<unsigned char,idxT>(min),
+                                                                                                std::max(2u, threads),
+                                                                                                tmp_dir,
+                                                                                                "Benchmark_" + std::to_string(getpid()))(T, max);
+   const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+   if(SA.size() != T.size() + 1){
+      std::cerr << "ERROR : engine ''" << engine << "'' returned " << SA.size() << " entries for " << T.size() << " characters\n";
+      exit(1);
+   }
+   return seconds;
+}
+
+///runs one build in a forked process, that is killed after *timeout* seconds
+Result run(const std::string& engine,
+           const std::string& corpus,
+           const uint64_t& size,
+           const unsigned& threads,
+           const unsigned& timeout){
+   Result r{engine, corpus, size, threads, "failed", 0, 0, 0};
+   int fd[2];
+   if(pipe(fd)){
+      std::cerr << "ERROR : Failed to create a pipe\n";
+      exit(1);
+   }
+   const pid_t pid = fork();
+   if(pid < 0){
+      std::cerr << "ERROR : Failed to start a run\n";
+      exit(1);
+   }
+   if(!pid){
+      close(fd[0]);
+      const std::vector<unsigned char> T = makeCorpus(corpus, size);
+      tbb::task_scheduler_init tbb_init(threads);
+      alarm(timeout);
+      const unsigned width = indexWidthForSize(size);
+      const double seconds = width == 4 ? build<unsigned>(engine, T, threads)
+                                        : (width == 5 ? build<uint40>(engine, T, threads) : build<uint64_t>(engine, T, threads));
+      const ssize_t w = write(fd[1], &seconds, sizeof(seconds));
+      _exit(w == sizeof(seconds) ? 0 : 1);
+   }
+   close(fd[1]);
+   double seconds;
+   const bool got = read(fd[0], &seconds, sizeof(seconds)) == sizeof(seconds);
+   close(fd[0]);
+   int status;
+   struct rusage usage;
+   wait4(pid, &status, 0, &usage);
+   r.peak_rss_kb = usage.ru_maxrss;
+   if(WIFEXITED(status) && !WEXITSTATUS(status) && got){
+      r.status = "ok";
+      r.seconds = seconds;
+   }
+   else if(WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM){
+      r.status = "timeout";
+   }
+   return r;
+}
+
+void writeCSV(std::ostream& out, const std::vector<Result>& results){
+   out << "engine,corpus,bytes,threads,status,seconds,mb_per_s,peak_rss_kb,efficiency\n";
+   for(const Result& r : results){
+      out << r.engine << ',' << r.corpus << ',' << r.size << ',' << r.threads << ',' << r.status << ',';
+      if(r.status == "ok")
+         out << r.seconds << ',' << (r.size / 1048576.0) / r.seconds << ',';
+      else
+         out << ",,";
+      out << r.peak_rss_kb << ',';
+      if(r.efficiency)
+         out << r.efficiency;
+      out << '\n';
+   }
+}
+
+void writeJSON(std::ostream& out, const std::vector<Result>& results){
+   out << "[\n";
+   for(size_t i = 0 ; i < results.size() ; ++i){
+      const Result& r = results[i];
+      out << "  {\"engine\": \"" << r.engine << "\", \"corpus\": \"" << r.corpus << "\", \"bytes\": " << r.size
+          << ", \"threads\": " << r.threads << ", \"status\": \"" << r.status << "\", ";
+      if(r.status == "ok")
+         out << "\"seconds\": " << r.seconds << ", \"mb_per_s\": " << (r.size / 1048576.0) / r.seconds << ", ";
+      else
+         out << "\"seconds\": null, \"mb_per_s\": null, ";
+      out << "\"peak_rss_kb\": " << r.peak_rss_kb << ", \"efficiency\": ";
+      if(r.efficiency)
+         out << r.efficiency;
+      else
+         out << "null";
+      out << (i + 1 < results.size() ? "},\n" : "}\n");
+   }
+   out << "]\n";
+}
+
+int main(int argc, char** argv){
+   std::vector<std::string> engines = Engines;
+   std::vector<std::string> corpora = corpusKinds();
+   std::vector<uint64_t> sizes = {1 << 20, 8 << 20, 32 << 20};
+   std::vector<unsigned> threads;
+   for(unsigned t = 1 ; t < std::thread::hardware_concurrency() ; t <<= 1){
+      threads.push_back(t);
+   }
+   threads.push_back(std::max(1u, std::thread::hardware_concurrency()));
+   unsigned timeout = 300;
+   bool json = false;
+   std::string out_f;
+
+   for(int i = 1 ; i < argc ; ++i){
+      const std::string arg(argv[i]);
+      if(arg == "-json"){
+         json = true;
+         continue;
+      }
+      if(i + 1 == argc){
+         std::cerr << "ERROR : no argument for mode ''" << arg << "''\n";
+         exit(1);
+      }
+      const std::string val(argv[++i]);
+      if(arg == "-e")
+         engines = split(val);
+      else if(arg == "-c")
+         corpora = split(val);
+      else if(arg == "-s"){
+         sizes.clear();
+         for(const std::string& s : split(val))
+            sizes.push_back(parseSize(s));
+      }
+      else if(arg == "-t"){
+         threads.clear();
+         for(const std::string& t : split(val))
+            threads.push_back(std::max(1ul, std::stoul(t)));
+         std::sort(threads.begin(), threads.end());
+      }
+      else if(arg == "-timeout")
+         timeout = std::stoul(val);
+      else if(arg == "-td")
+         tmp_dir = val;
+      else if(arg == "-mc")
+         mem_cap = std::max(1ull, std::stoull(val));
+      else if(arg == "-o")
+         out_f = val;
+      else{
+         std::cerr << "ERROR : mode ''" << arg << "'' unknown\n";
+         exit(1);
+      }
+   }
+   for(const std::string& e : engines){
+      if(std::find(Engines.begin(), Engines.end(), e) == Engines.end()){
+         std::cerr << "ERROR : engine ''" << e << "'' unknown\n";
+         exit(1);
+      }
+   }
+   for(const std::string& c : corpora)
+      makeCorpus(c, 0);
+
+   ///serial engines run with one thread only, the efficiency of a parallel run is relative to its run with the fewest threads
+   std::vector<Result> results;
+   for(const std::string& c : corpora){
+      for(const uint64_t& s : sizes){
+         for(const std::string& e : engines){
+            const bool parallel = std::find(ParallelEngines.begin(), ParallelEngines.end(), e) != ParallelEngines.end();
+            const size_t base = results.size();
+            for(const unsigned& t : threads){
+               if(!parallel && t != threads[0])
+                  break;
+               results.push_back(run(e, c, s, parallel ? t : 1, timeout));
+               Result& r = results.back();
+               std::cerr << r.engine << '\t' << r.corpus << '\t' << r.size << '\t' << r.threads << '\t'
+                         << r.status << '\t' << r.seconds << "s\n";
+               const Result& b = results[base];
+               if(parallel && r.status == "ok" && b.status == "ok")
+                  r.efficiency = (b.seconds * b.threads) / (r.seconds * r.threads);
+               if(r.status != "ok")
+                  break;
+            }
+         }
+      }
+   }
+
+   if(out_f.size()){
+      std::ofstream out(out_f);
+      if(!out.is_open()){
+         std::cerr << "ERROR : Failed to open ''" << out_f << "'' for writing\n";
+         exit(1);
+      }
+      json ? writeJSON(out, results) : writeCSV(out, results);
+   }
+   else{
+      json ? writeJSON(std::cout, results) : writeCSV(std::cout, results);
+   }
+}
@@ -25,42 +25,99 @@ reading the stored data takes up too much time.
 
 ///AlphabetType
 //the input is stored temporarily in SuffixArray as vector of type AlphabetType
-//IF *alph* SET TO A DATA-TYPE,THAT IS SMALLER THAN UNSIGNED AND LCP IS USED, THERE IS A SEGMENTATION FAULT WITH MY TEST-CORPUS!!
-//PROBALY MULTIPLE ENCODINGS IN THE TEST-CORPUS
-typedef unsigned char AlphabetType;
+//chosen at runtime: 1 byte(unsigned char), 2 bytes(uint16_t) or 4 bytes(uint32_t), see "-sym" and "-utf8"
 
 ///IndexType
 //determines the type of indices, that are stored in the final suffix-array
-typedef unsigned IndexType;
+//chosen at runtime from the size of the input: 4 bytes(unsigned), 5 bytes(uint40) or 8 bytes(uint64_t)
+//see "IndexTypes.hpp"
 
 
-/*
-void stop_print_time(std::chrono::steady_clock start){
-   
+///builds or searches the suffix-array with symbols of type *AlphabetType* and indices of type *idxT*
+template<typename AlphabetType, typename idxT>
+void run(const Modes& modes){
+   if(modes.shortInput() || !modes["Infix"].size()){
+      ///in SuffixArray.hpp
+      SuffixArray<AlphabetType, idxT> SA(modes);
+   }
+   else if(isSegmentedIndex(headerOfStored(modes["InFile"]))){
+      ///in SuffixArray.hpp
+      SuffixArray<AlphabetType, idxT>().findInSegmentsInF(modes["Infix"], 
+                                                          modes["InFile"], 
+                                                          modes["SubstringWidth"]);
+   }
+   else{
+      ///in SuffixArray.hpp
+      findInfix<AlphabetType, idxT>(modes["Infix"], 
+                                    modes["InFile"], 
+                                    modes["SubstringWidth"]);
+   }
+}
+
+template<typename AlphabetType>
+void run(const Modes& modes, const unsigned& idx_width){
+   if(idx_width == 4)
+      run<AlphabetType, unsigned>(modes);
+   else if(idx_width == 5)
+      run<AlphabetType, uint40>(modes);
+   else
+      run<AlphabetType, uint64_t>(modes);
+}
+
+///bytes per symbol of the input-corpus, UTF-8 takes 4 bytes only if it holds code-points above 0xFFFF,
+///with ''-docs'' the widest of the listed documents
+unsigned symbolWidthForFile(const Modes& modes){
+   const unsigned width = std::stoul(modes["SymbolWidth"]) / 8;
+   if(!parse_flag(modes["UTF8"]) || width > 1)
+      return width;
+   if(parse_flag(modes["Documents"])){
+      unsigned widest = 1;
+      for(const std::string& path : documentPaths(modes["InFile"])){
+         struct stat st;
+         if(stat(path.c_str(), &st) || !st.st_size)
+            continue;
+         MappedFile<unsigned char> in(path);
+         widest = std::max(widest, utf8SymbolWidth(in.data(), in.data() + in.size()));
+      }
+      return widest;
+   }
+   MappedFile<unsigned char> in(modes["InFile"]);
+   return utf8SymbolWidth(in.data(), in.data() + in.size());
 }
-*/
 
 int main(int argc, char** argv){
    auto start(std::chrono::steady_clock::now());
    ///in "parseModes.hpp"
    Modes modes = Modes(argc, argv);
 
-   if(modes.shortInput() || !modes["Infix"].size()){
-      ///in SuffixArray.hpp
-      SuffixArray<AlphabetType, IndexType> SA(modes);
+   unsigned idx_width, sym_width = 1;
+   ///all segments of a segmented index have the widths of its first segment
+   const std::string index = modes["Merge"].size() ? modes["Merge"] : modes["Append"];
+   if(index.size() && !access(index.c_str(), R_OK)){
+      idx_width = indexWidthOfStored(index);
+      sym_width = alphabetWidthFromCode(headerOfStored(index));
+   }
+   else if(modes.shortInput() || !modes["Infix"].size()){
+      idx_width = parse_flag(modes["Documents"]) ? indexWidthForSize(documentsSize(documentPaths(modes["InFile"])))
+                                                 : indexWidthForFile(modes["InFile"]);
+      if(!access(modes["InFile"].c_str(), R_OK))
+         sym_width = symbolWidthForFile(modes);
    }
    else{
       if(!modes["InFile"].size()){
          std::cerr << "ERROR : SuffixArray previously stored data-file ''-i'' not specified!\n";
          exit(1);
       }
-      else{
-         ///in SuffixArray.hpp
-         findInfix<AlphabetType, IndexType>(modes["Infix"], 
-                                            modes["InFile"], 
-                                            modes["SubstringWidth"]);
-      }
+      idx_width = indexWidthOfStored(modes["InFile"]);
+      sym_width = alphabetWidthFromCode(headerOfStored(modes["InFile"]));
    }
+   
+   if(sym_width == 1)
+      run<unsigned char>(modes, idx_width);
+   else if(sym_width == 2)
+      run<uint16_t>(modes, idx_width);
+   else
+      run<uint32_t>(modes, idx_width);
 
    std::cout << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count() << "s\n";
 }